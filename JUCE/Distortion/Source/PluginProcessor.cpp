@@ -10,8 +10,7 @@ DistortionAudioProcessor::DistortionAudioProcessor()
 
 DistortionAudioProcessor::~DistortionAudioProcessor()
 {
-    this->OSCReceiver::disconnect();
-    this->OSCReceiver::removeListener(this);
+    oscReceiver.disconnect();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout DistortionAudioProcessor::createParameters()
@@ -30,12 +29,10 @@ void DistortionAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBl
     
     inputGain.prepare(spec);
     
-    if (!this->OSCReceiver::connect(9003))
-        DBG("OSC Receiver: failed to connect to port 9003");
+    if (!oscReceiver.connect(oscPort, *this))
+        DBG("OSC Receiver: failed to connect to port " << oscPort);
     else
-        DBG("OSC connected to port 9003");
-    
-    this->OSCReceiver::addListener(this, "/drive");
+        DBG("OSC connected to port " << oscPort);
 }
 
 void DistortionAudioProcessor::releaseResources()
@@ -44,6 +41,8 @@ void DistortionAudioProcessor::releaseResources()
 
 void DistortionAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
+    juce::ScopedNoDenormals noDenormals;
+
     driveParam = apvts.getRawParameterValue("DRIVE")->load();
     
     // Aumentamos el rango de ganancia de 1-10 a 1-25 para una distorsión más agresiva
@@ -68,16 +67,32 @@ void DistortionAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, ju
             channelData[sample] *= 1.0f / (0.3f + driveParam * 0.7f);
         }
     }
+
+    // Non finite output resets the gain stage, see DspSafety.h
+    if (DspSafety::containsNonFinite(buffer))
+    {
+        buffer.clear();
+        inputGain.reset();
+    }
 }
 
-void DistortionAudioProcessor::oscMessageReceived(const juce::OSCMessage& message)
+// Runs on the OSC receiver thread
+void DistortionAudioProcessor::oscMessageReceived(const OscCodec::MessageView& message)
 {
-    if (message.getAddressPattern().toString() == "/drive" && 
-        message.size() == 1 && 
-        message[0].isFloat32())
+    if (message.hasAddress("/drive") &&
+        message.size() == 1 &&
+        message.isFloat32(0))
     {
-        float value = juce::jlimit(0.0f, 1.0f, message[0].getFloat32());
-        apvts.getParameter("DRIVE")->setValueNotifyingHost(value);
+        auto* parameter = apvts.getParameter("DRIVE");
+        float value = DspSafety::sanitise(message.getFloat32(0), 0.0f, 1.0f, parameter->getValue());
+
+        const bool forward = driveConditioner.process(value, value);
+        driveConditioner.logStats("Distortion", "/drive");
+
+        if (!forward)
+            return;
+
+        parameter->setValueNotifyingHost(value);
         DBG("OSC /drive received: " << value);
     }
 }
@@ -1,9 +1,12 @@
 #pragma once
 #include <JuceHeader.h>
+#include "../../Shared/ControlConditioner.h"
+#include "../../Shared/DspSafety.h"
+#include "../../Shared/OscCodec.h"
+#include "../../Shared/Station.h"
 
 class DistortionAudioProcessor : public juce::AudioProcessor,
-                               private juce::OSCReceiver,
-                               private juce::OSCReceiver::ListenerWithOSCAddress<juce::OSCReceiver::MessageLoopCallback>
+                               private OscCodec::Receiver::Listener
 {
 public:
     DistortionAudioProcessor();
@@ -32,11 +35,14 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
 private:
-    void oscMessageReceived(const juce::OSCMessage& message) override;
+    void oscMessageReceived(const OscCodec::MessageView& message) override;
 
     juce::dsp::Gain<float> inputGain;
     juce::AudioProcessorValueTreeState apvts;
     float driveParam = 0.5f;
+    ControlConditioner driveConditioner { ControlConditioner::normalised() };
+    const int oscPort = Station::port(9003, Station::current());
+    OscCodec::Receiver oscReceiver;
     
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
 
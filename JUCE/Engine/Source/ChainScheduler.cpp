@@ -0,0 +1,179 @@
+#include "ChainScheduler.h"
+#include "Realtime.h"
+#include <thread>
+
+namespace
+{
+    juce::uint64 packRange(juce::uint64 front, juce::uint64 back) noexcept { return front | (back << 32); }
+    juce::uint32 rangeFront(juce::uint64 bounds) noexcept { return (juce::uint32) bounds; }
+    juce::uint32 rangeBack(juce::uint64 bounds) noexcept  { return (juce::uint32) (bounds >> 32); }
+}
+
+class ChainScheduler::Worker : public juce::Thread
+{
+public:
+    Worker(ChainScheduler& ownerToUse, int rangeIndexToUse, int realtimePriorityToUse)
+        : Thread("Chain worker " + juce::String(rangeIndexToUse)),
+          owner(ownerToUse), rangeIndex(rangeIndexToUse), realtimePriority(realtimePriorityToUse)
+    {
+    }
+
+    void run() override
+    {
+        Realtime::promoteCurrentThread(realtimePriority);
+        int idleSpins = 0;
+        int seenBlock = owner.block.load(std::memory_order_acquire);
+
+        while (!threadShouldExit())
+        {
+            if (owner.runOneTask(rangeIndex))
+            {
+                idleSpins = 0;
+                continue;
+            }
+
+            const int currentBlock = owner.block.load(std::memory_order_acquire);
+
+            if (currentBlock != seenBlock)
+            {
+                seenBlock = currentBlock;
+                idleSpins = 0;
+                continue;
+            }
+
+            // Spin a little so back to back blocks find us awake, then park until the next block.
+            // A worker that oversleeps only costs parallelism: its tasks get stolen
+            if (++idleSpins < spinLimit)
+                std::this_thread::yield();
+            else
+                owner.sleepUntilNextBlock(seenBlock);
+        }
+    }
+
+private:
+    static constexpr int spinLimit = 2000;
+
+    ChainScheduler& owner;
+    const int rangeIndex;
+    const int realtimePriority;
+};
+
+//==============================================================================
+ChainScheduler::ChainScheduler(int numWorkers, int realtimePriority)
+    : numRanges(juce::jmax(0, numWorkers) + 1),
+      ranges(new TaskRange[(size_t) numRanges])
+{
+    for (int i = 1; i < numRanges; ++i)
+    {
+        auto* worker = workers.add(new Worker(*this, i, realtimePriority));
+        worker->startThread(juce::Thread::Priority::highest);
+    }
+}
+
+ChainScheduler::~ChainScheduler()
+{
+    for (auto* worker : workers)
+        worker->signalThreadShouldExit();
+
+    block.fetch_add(1);
+    block.notify_all();
+
+    for (auto* worker : workers)
+        worker->stopThread(1000);
+}
+
+void ChainScheduler::process(Job& job, int numTasks) noexcept
+{
+    if (numTasks <= 0)
+        return;
+
+    currentJob.store(&job, std::memory_order_relaxed);
+    remaining.store(numTasks, std::memory_order_relaxed);
+
+    // Even split rounded towards the audio thread, which needs no wake up. Published with release so
+    // a thread that takes a task also sees the job and its buffers
+    for (int r = 0; r < numRanges; ++r)
+    {
+        const auto front = (juce::uint64) ((numTasks * r + numRanges - 1) / numRanges);
+        const auto back = (juce::uint64) ((numTasks * (r + 1) + numRanges - 1) / numRanges);
+        ranges[(size_t) r].bounds.store(packRange(front, back), std::memory_order_release);
+    }
+
+    // Either a parking worker sees the new block, or we see it in sleepers and wake it (both seq_cst)
+    block.fetch_add(1);
+
+    if (sleepers.load() > 0)
+        block.notify_all();
+
+    while (runOneTask(0))
+    {
+    }
+
+    // Barrier: the remaining tasks are already running on workers, wait for them to finish
+    while (remaining.load(std::memory_order_acquire) > 0)
+        std::this_thread::yield();
+}
+
+bool ChainScheduler::runOneTask(int rangeIndex) noexcept
+{
+    int task = -1;
+
+    if (!takeFront(ranges[(size_t) rangeIndex], task))
+    {
+        bool stolen = false;
+
+        for (int i = 1; i < numRanges && !stolen; ++i)
+            stolen = takeBack(ranges[(size_t) ((rangeIndex + i) % numRanges)], task);
+
+        if (!stolen)
+            return false;
+    }
+
+    currentJob.load(std::memory_order_acquire)->perform(task);
+    remaining.fetch_sub(1, std::memory_order_acq_rel);
+    return true;
+}
+
+void ChainScheduler::sleepUntilNextBlock(int seenBlock) noexcept
+{
+    sleepers.fetch_add(1);
+
+    if (block.load() == seenBlock)
+        block.wait(seenBlock);
+
+    sleepers.fetch_sub(1);
+}
+
+bool ChainScheduler::takeFront(TaskRange& range, int& task) noexcept
+{
+    auto bounds = range.bounds.load(std::memory_order_acquire);
+
+    while (rangeFront(bounds) < rangeBack(bounds))
+    {
+        if (range.bounds.compare_exchange_weak(bounds, packRange(rangeFront(bounds) + 1, rangeBack(bounds)),
+                                               std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            task = (int) rangeFront(bounds);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ChainScheduler::takeBack(TaskRange& range, int& task) noexcept
+{
+    auto bounds = range.bounds.load(std::memory_order_acquire);
+
+    while (rangeFront(bounds) < rangeBack(bounds))
+    {
+        if (range.bounds.compare_exchange_weak(bounds, packRange(rangeFront(bounds), rangeBack(bounds) - 1),
+                                               std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            task = (int) rangeBack(bounds) - 1;
+            return true;
+        }
+    }
+
+    return false;
+}
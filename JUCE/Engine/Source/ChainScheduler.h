@@ -0,0 +1,54 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Runs the independent tasks of one audio block (one per effect chain) on a pool of real time
+// worker threads. At the start of a block the tasks are split into one range per thread; each thread
+// takes tasks from the front of its own range and, once it is empty, steals from the back of the
+// others. The audio thread works as well and only returns when every task of the block is done,
+// which is the barrier between blocks. Between blocks the workers spin on a block counter, then park
+// on it with std::atomic::wait (a futex on Linux). The audio thread only makes the wake up call when a
+// worker has announced that it is parked, and never takes a lock.
+class ChainScheduler
+{
+public:
+    struct Job
+    {
+        virtual ~Job() = default;
+        virtual void perform(int taskIndex) noexcept = 0;
+    };
+
+    ChainScheduler(int numWorkers, int realtimePriority);
+    ~ChainScheduler();
+
+    int getNumWorkers() const noexcept { return workers.size(); }
+
+    // Audio thread: runs job.perform(0 ... numTasks - 1) and returns once all of them have finished
+    void process(Job& job, int numTasks) noexcept;
+
+private:
+    class Worker;
+
+    // One per thread, index 0 belongs to the audio thread. Front in the low 32 bits, back in the
+    // high 32 bits, so owner and thieves agree through a single compare-and-swap
+    struct alignas(64) TaskRange
+    {
+        std::atomic<juce::uint64> bounds { 0 };
+    };
+
+    bool runOneTask(int rangeIndex) noexcept;
+    void sleepUntilNextBlock(int seenBlock) noexcept;
+    static bool takeFront(TaskRange& range, int& task) noexcept;
+    static bool takeBack(TaskRange& range, int& task) noexcept;
+
+    const int numRanges;
+    std::unique_ptr<TaskRange[]> ranges;
+    std::atomic<Job*> currentJob { nullptr };
+    std::atomic<int> remaining { 0 };
+    std::atomic<int> block { 0 };    // Bumped once per process() call and on shutdown
+    std::atomic<int> sleepers { 0 }; // Workers parked on block
+    juce::OwnedArray<Worker> workers;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ChainScheduler)
+};
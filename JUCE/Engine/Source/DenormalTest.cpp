@@ -0,0 +1,244 @@
+#include "DenormalTest.h"
+#include "NullAudioDevice.h"
+#include <iostream>
+
+namespace
+{
+    struct Window
+    {
+        float peak = 0.0f;
+        double maxMicros = 0.0;
+        double totalMicros = 0.0;
+        int numBlocks = 0;
+    };
+
+    // Runs the chain straight from the device callback, times it and records the output peak, one
+    // entry per window of audio. Everything is allocated before the device starts
+    class TailProbe : public juce::AudioIODeviceCallback
+    {
+    public:
+        TailProbe(EffectChain& chainToUse, bool hostFlushingToUse, int numWindows, juce::int64 samplesPerWindowToUse,
+                  juce::int64 noteOffSampleToUse)
+            : chain(chainToUse), hostFlushing(hostFlushingToUse), windows((size_t) numWindows),
+              samplesPerWindow(samplesPerWindowToUse), noteOffSample(noteOffSampleToUse)
+        {
+        }
+
+        void audioDeviceAboutToStart(juce::AudioIODevice* device) override
+        {
+            block.setSize(2, device->getCurrentBufferSizeSamples());
+            notes.ensureSize(256);
+            chain.prepare(device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples());
+        }
+
+        void audioDeviceStopped() override
+        {
+            chain.release();
+        }
+
+        void audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannels,
+                                              float* const* outputChannelData, int numOutputChannels,
+                                              int numSamples, const juce::AudioIODeviceCallbackContext&) override
+        {
+            // The device thread starts with the FPU defaults, set the mode of this pass once. The plugins'
+            // ScopedNoDenormals put it back at the end of each processBlock
+            if (samplesProcessed == 0)
+                juce::FloatVectorOperations::disableDenormalisedNumberSupport(hostFlushing);
+
+            const int n = juce::jmin(numSamples, block.getNumSamples());
+
+            for (int ch = 0; ch < 2; ++ch)
+            {
+                if (ch < numInputChannels && inputChannelData[ch] != nullptr)
+                    block.copyFrom(ch, 0, inputChannelData[ch], n);
+                else
+                    block.clear(ch, 0, n);
+            }
+
+            if (samplesProcessed == 0)
+                notes.addEvent(juce::MidiMessage::noteOn(1, 60, 1.0f), 0);
+
+            if (noteOffSample >= samplesProcessed && noteOffSample < samplesProcessed + n)
+                notes.addEvent(juce::MidiMessage::noteOff(1, 60), (int) (noteOffSample - samplesProcessed));
+
+            juce::AudioBuffer<float> chunk(block.getArrayOfWritePointers(), 2, n);
+
+            const auto start = juce::Time::getHighResolutionTicks();
+            chain.process(chunk, notes);
+            const double micros = 1.0e6 * juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - start);
+
+            for (int ch = 0; ch < numOutputChannels; ++ch)
+                if (outputChannelData[ch] != nullptr)
+                    juce::FloatVectorOperations::copy(outputChannelData[ch], block.getReadPointer(ch % 2), n);
+
+            const auto index = (size_t) (samplesProcessed / samplesPerWindow);
+            samplesProcessed += n;
+
+            if (index >= windows.size())
+            {
+                finished = true;
+                return;
+            }
+
+            auto& window = windows[index];
+            window.maxMicros = juce::jmax(window.maxMicros, micros);
+            window.totalMicros += micros;
+            ++window.numBlocks;
+
+            for (int ch = 0; ch < 2; ++ch)
+                window.peak = juce::jmax(window.peak, block.getMagnitude(ch, 0, n));
+        }
+
+        bool isFinished() const noexcept { return finished.load(); }
+        const std::vector<Window>& getWindows() const noexcept { return windows; }
+
+    private:
+        EffectChain& chain;
+        const bool hostFlushing;
+        std::vector<Window> windows;
+        const juce::int64 samplesPerWindow, noteOffSample;
+        juce::int64 samplesProcessed = 0;
+        juce::AudioBuffer<float> block;
+        juce::MidiBuffer notes;
+        std::atomic<bool> finished { false };
+    };
+
+    // A full scale stereo click, the Null device reads silence once the file has ended
+    bool writeImpulse(const juce::File& file, double sampleRate)
+    {
+        auto stream = std::make_unique<juce::FileOutputStream>(file);
+        if (!stream->openedOk())
+            return false;
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(juce::WavAudioFormat().createWriterFor(stream.get(), sampleRate, 2, 24, {}, 0));
+        if (writer == nullptr)
+            return false;
+
+        stream.release(); // Now owned by the writer
+
+        juce::AudioBuffer<float> impulse(2, 64);
+        impulse.clear();
+        impulse.setSample(0, 0, 1.0f);
+        impulse.setSample(1, 0, 1.0f);
+        return writer->writeFromAudioSampleBuffer(impulse, 0, impulse.getNumSamples());
+    }
+
+    // Worst and mean block time of the windows from firstWindow on
+    void summarise(const std::vector<Window>& windows, int firstWindow, int endWindow, double& worst, double& mean)
+    {
+        double total = 0.0;
+        int blocks = 0;
+        worst = 0.0;
+
+        for (int i = firstWindow; i < endWindow; ++i)
+        {
+            worst = juce::jmax(worst, windows[(size_t) i].maxMicros);
+            total += windows[(size_t) i].totalMicros;
+            blocks += windows[(size_t) i].numBlocks;
+        }
+
+        mean = blocks > 0 ? total / blocks : 0.0;
+    }
+
+    juce::String column(const juce::String& text, int width)
+    {
+        return text.paddedLeft(' ', width);
+    }
+}
+
+bool DenormalTest::run(const juce::OwnedArray<EffectChain>& chains) const
+{
+    juce::TemporaryFile impulseFile(".wav");
+
+    if (!writeImpulse(impulseFile.getFile(), sampleRate))
+    {
+        std::cerr << "Cannot write " << impulseFile.getFile().getFullPathName() << std::endl;
+        return false;
+    }
+
+    auto& chain = *chains.getFirst();
+    const int numWindows = juce::jmax(1, juce::roundToInt(seconds / windowSeconds));
+    const auto samplesPerWindow = juce::jmax((juce::int64) blockSize, (juce::int64) (windowSeconds * sampleRate));
+    std::vector<Window> passes[2]; // Plugins only, then host FTZ/DAZ
+
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        TailProbe probe(chain, pass == 1, numWindows, samplesPerWindow, (juce::int64) (noteSeconds * sampleRate));
+        NullAudioIODevice device(impulseFile.getFile(), {}, true);
+
+        juce::BigInteger channels;
+        channels.setRange(0, 2, true);
+
+        const auto error = device.open(channels, channels, sampleRate, blockSize);
+        if (error.isNotEmpty())
+        {
+            std::cerr << error << std::endl;
+            return false;
+        }
+
+        device.start(&probe);
+
+        while (!probe.isFinished())
+            juce::Thread::sleep(10);
+
+        device.stop();
+        device.close();
+        passes[pass] = probe.getWindows();
+    }
+
+    const auto& plugins = passes[0];
+    const auto& host = passes[1];
+
+    std::cout << "Denormal test: a note and an impulse, then silence for " << seconds << " s through "
+              << chain.getPluginNames().joinIntoString(" -> ") << ", blocks of " << blockSize << " samples at "
+              << sampleRate << " Hz\n"
+              << column("time s", 8) << column("peak", 12) << column("plugins us", 12) << column("host FTZ us", 13)
+              << "  (worst block)" << std::endl;
+
+    // Once quiet, the tail counts as denormal for good even if a window is flushed to exact zero
+    int firstDenormalWindow = -1;
+
+    for (int i = 0; i < numWindows; ++i)
+    {
+        if (firstDenormalWindow < 0 && plugins[(size_t) i].peak < denormalThreshold)
+            firstDenormalWindow = i;
+
+        std::cout << column(juce::String(i * windowSeconds, 1), 8)
+                  << column(juce::String(plugins[(size_t) i].peak, 3, true), 12)
+                  << column(juce::String(plugins[(size_t) i].maxMicros, 1), 12)
+                  << column(juce::String(host[(size_t) i].maxMicros, 1), 13)
+                  << (i == firstDenormalWindow ? "  <- tail below " + juce::String(denormalThreshold, 0, true) : juce::String())
+                  << std::endl;
+    }
+
+    if (firstDenormalWindow < 0)
+    {
+        std::cerr << "The tail never went below " << denormalThreshold << ", try a longer --denormal-test" << std::endl;
+        return false;
+    }
+
+    double pluginsWorstBefore, pluginsMeanBefore, pluginsWorst, pluginsMean, hostWorst, hostMean;
+    summarise(plugins, 0, firstDenormalWindow, pluginsWorstBefore, pluginsMeanBefore);
+    summarise(plugins, firstDenormalWindow, numWindows, pluginsWorst, pluginsMean);
+    summarise(host, firstDenormalWindow, numWindows, hostWorst, hostMean);
+
+    const double slowdown = hostMean > 0.0 ? pluginsMean / hostMean : 0.0;
+
+    std::cout << "before the tail went denormal   worst " << juce::String(pluginsWorstBefore, 1) << " us, mean "
+              << juce::String(pluginsMeanBefore, 2) << " us\n"
+              << "after, plugin flushing only     worst " << juce::String(pluginsWorst, 1) << " us, mean "
+              << juce::String(pluginsMean, 2) << " us\n"
+              << "after, host FTZ/DAZ             worst " << juce::String(hostWorst, 1) << " us, mean "
+              << juce::String(hostMean, 2) << " us\n"
+              << "slowdown without host flushing  " << juce::String(slowdown, 2) << "x (limit "
+              << juce::String(maxSlowdown, 1) << "x, deadline " << juce::String(1.0e6 * blockSize / sampleRate, 1)
+              << " us)" << std::endl;
+
+    if (slowdown > maxSlowdown)
+    {
+        std::cerr << "A plugin of the chain lets denormals through" << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "EffectChain.h"
+
+// Plays one note (and one impulse, for chains without the Synth) followed by silence through the
+// first chain on a freewheeling Null device and prints, for every window of audio, the output peak
+// and the worst callback time. The tails decay towards the denormal range, where an unflushed FPU
+// slows down by an order of magnitude.
+// The chain is called directly, without RealtimeAudioEngine and its ScopedNoDenormals, so only the
+// plugins' own flushing protects the first pass. The second pass forces FTZ/DAZ from the host, which
+// is how the chain would run if every plugin flushed: a plugin that doesn't makes the first pass
+// slower than the second once the tail is quiet, and the test fails
+struct DenormalTest
+{
+    double sampleRate = 48000.0;
+    int blockSize = 64;
+    double seconds = 30.0;       // Of audio, long enough for the default reverb tail to reach the range
+    double windowSeconds = 1.0;
+    double noteSeconds = 0.2;
+
+    // Output peaks below this count as a denormal tail, the state behind them is a few multiplies away
+    // from the subnormal range (below 1.2e-38)
+    static constexpr float denormalThreshold = 1.0e-30f;
+
+    // Mean block time of the quiet tail, plugins only against host FTZ/DAZ, above which the test fails
+    static constexpr double maxSlowdown = 2.0;
+
+    // Returns false if the test could not run or the plugins let denormals through
+    bool run(const juce::OwnedArray<EffectChain>& chains) const;
+};
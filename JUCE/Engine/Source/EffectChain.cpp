@@ -0,0 +1,89 @@
+#include "EffectChain.h"
+
+EffectChain::EffectChain()
+{
+    formatManager.addFormat(new juce::VST3PluginFormat());
+}
+
+EffectChain::~EffectChain()
+{
+    release();
+}
+
+bool EffectChain::load(const juce::Array<juce::File>& pluginFiles, double sampleRate, int blockSize, juce::String& error)
+{
+    for (auto& file : pluginFiles)
+    {
+        juce::OwnedArray<juce::PluginDescription> types;
+
+        for (auto* format : formatManager.getFormats())
+            if (format->fileMightContainThisPluginType(file.getFullPathName()))
+                format->findAllTypesForFile(types, file.getFullPathName());
+
+        if (types.isEmpty())
+        {
+            error = "No plugin found in " + file.getFullPathName();
+            return false;
+        }
+
+        auto instance = formatManager.createPluginInstance(*types[0], sampleRate, blockSize, error);
+        if (instance == nullptr)
+        {
+            error = "Cannot load " + file.getFullPathName() + ": " + error;
+            return false;
+        }
+
+        instance->enableAllBuses();
+        plugins.push_back(std::move(instance));
+    }
+
+    return true;
+}
+
+void EffectChain::prepare(double sampleRate, int blockSize)
+{
+    midi.ensureSize(256);
+
+    for (auto& plugin : plugins)
+    {
+        plugin->setRateAndBufferSizeDetails(sampleRate, blockSize);
+        plugin->prepareToPlay(sampleRate, blockSize);
+    }
+}
+
+void EffectChain::release()
+{
+    for (auto& plugin : plugins)
+        plugin->releaseResources();
+}
+
+void EffectChain::process(juce::AudioBuffer<float>& buffer) noexcept
+{
+    midi.clear();
+    process(buffer, midi);
+}
+
+void EffectChain::process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) noexcept
+{
+    for (auto& plugin : plugins)
+    {
+        plugin->processBlock(buffer, midiMessages);
+        midiMessages.clear();
+    }
+}
+
+int EffectChain::getLatencySamples() const
+{
+    int latency = 0;
+    for (auto& plugin : plugins)
+        latency += plugin->getLatencySamples();
+    return latency;
+}
+
+juce::StringArray EffectChain::getPluginNames() const
+{
+    juce::StringArray names;
+    for (auto& plugin : plugins)
+        names.add(plugin->getName());
+    return names;
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// The T.I.L.E.S plugins loaded from their VST3 bundles and processed in series, the same chain
+// HostConf.filtergraph builds inside AudioPluginHost: the Synth plays the MIDI notes and the
+// effects process its output
+class EffectChain
+{
+public:
+    EffectChain();
+    ~EffectChain();
+
+    // Default chain, in the order of HostConf.filtergraph. The bundle names are those of the VST3
+    // builds, the OSCSender project builds OSCStreaming.vst3
+    static juce::StringArray getDefaultPluginNames() { return { "Synth", "Distortion", "Reverb", "Filters", "OSCStreaming" }; }
+
+    // Must be called on the message thread, before the device starts
+    bool load(const juce::Array<juce::File>& pluginFiles, double sampleRate, int blockSize, juce::String& error);
+
+    void prepare(double sampleRate, int blockSize);
+    void release();
+
+    // Audio thread, no allocations: the MIDI buffer is reused and stays empty
+    void process(juce::AudioBuffer<float>& buffer) noexcept;
+
+    // Same with notes for the first plugin, the Synth. The effects after it get no MIDI, so
+    // midiMessages is left empty
+    void process(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) noexcept;
+
+    int getLatencySamples() const;
+    int getNumPlugins() const { return (int) plugins.size(); }
+    juce::StringArray getPluginNames() const;
+
+private:
+    juce::AudioPluginFormatManager formatManager;
+    std::vector<std::unique_ptr<juce::AudioPluginInstance>> plugins;
+    juce::MidiBuffer midi;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EffectChain)
+};
@@ -0,0 +1,364 @@
+#include <JuceHeader.h>
+#include <cstdlib>
+#include <iostream>
+#include "ChainScheduler.h"
+#include "DenormalTest.h"
+#include "EffectChain.h"
+#include "NullAudioDevice.h"
+#include "OscBenchmark.h"
+#include "Realtime.h"
+#include "RealtimeAudioEngine.h"
+#include "ScalingBenchmark.h"
+#include "../../Shared/Station.h"
+
+// Standalone host for the effect chain, replaces AudioPluginHost + HostConf.filtergraph on the Linux boxes
+class EngineApplication : public juce::JUCEApplication
+{
+public:
+    EngineApplication() {}
+
+    const juce::String getApplicationName() override       { return ProjectInfo::projectName; }
+    const juce::String getApplicationVersion() override    { return ProjectInfo::versionString; }
+    bool moreThanOneInstanceAllowed() override             { return true; }
+
+    void initialise(const juce::String&) override
+    {
+        juce::ArgumentList args(getApplicationName(), getCommandLineParameterArray());
+
+        if (args.containsOption("--help|-h"))
+        {
+            printUsage();
+            quit();
+            return;
+        }
+
+        const juce::String deviceType = args.getValueForOption("--device-type");
+        const juce::String deviceName = args.getValueForOption("--device");
+        const int bufferSize = args.getValueForOption("--buffer").getIntValue();
+        const double sampleRate = args.getValueForOption("--rate").getDoubleValue();
+        const int priority = args.containsOption("--rt-priority") ? args.getValueForOption("--rt-priority").getIntValue() : 80;
+        const double seconds = args.getValueForOption("--seconds").getDoubleValue();
+        const bool latencyReport = args.containsOption("--latency-report");
+        const int requestedChains = juce::jmax(1, args.containsOption("--chains") ? args.getValueForOption("--chains").getIntValue() : 1);
+
+        // The audio thread runs chains too, so one worker less than the cores is enough
+        const int maxWorkers = juce::jmax(0, juce::SystemStats::getNumCpus() - 1);
+        const int numWorkers = args.containsOption("--workers") ? juce::jlimit(0, 64, args.getValueForOption("--workers").getIntValue())
+                                                                : maxWorkers;
+
+        const auto inputFile = args.containsOption("--input") ? args.getFileForOption("--input") : juce::File();
+        const auto outputFile = args.containsOption("--output") ? args.getFileForOption("--output") : juce::File();
+
+        if (inputFile != juce::File() && !inputFile.existsAsFile())
+        {
+            fail("Input file not found: " + inputFile.getFullPathName());
+            return;
+        }
+
+        if (args.containsOption("--osc-benchmark"))
+        {
+            OscBenchmark benchmark;
+            benchmark.samplesPerChannel = bufferSize > 0 ? bufferSize : benchmark.samplesPerChannel;
+
+            const double secondsPerTest = args.getValueForOption("--osc-benchmark").getDoubleValue();
+            benchmark.secondsPerTest = secondsPerTest > 0.0 ? secondsPerTest : benchmark.secondsPerTest;
+
+            benchmark.run();
+            quit();
+            return;
+        }
+
+        if (args.containsOption("--denormal-test"))
+        {
+            DenormalTest test;
+            test.sampleRate = sampleRate > 0.0 ? sampleRate : test.sampleRate;
+            test.blockSize = bufferSize > 0 ? bufferSize : test.blockSize;
+
+            const double testSeconds = args.getValueForOption("--denormal-test").getDoubleValue();
+            test.seconds = testSeconds > 0.0 ? testSeconds : test.seconds;
+
+            if (loadChains(args, 1, test.sampleRate, test.blockSize))
+            {
+                if (test.run(chains))
+                    quit();
+                else
+                    fail("Denormal test failed");
+            }
+            return;
+        }
+
+        if (args.containsOption("--benchmark"))
+        {
+            ScalingBenchmark benchmark;
+            benchmark.numWorkers = numWorkers;
+            benchmark.realtimePriority = priority;
+            benchmark.sampleRate = sampleRate > 0.0 ? sampleRate : benchmark.sampleRate;
+            benchmark.blockSize = bufferSize > 0 ? bufferSize : benchmark.blockSize;
+
+            // Every chain gets its own channel pair on the Null device
+            const int maxChains = args.getValueForOption("--benchmark").getIntValue();
+            const int benchmarkChains = juce::jlimit(1, NullAudioIODevice::maxChannels / 2, maxChains > 0 ? maxChains : juce::jmax(2, maxWorkers + 1));
+
+            if (loadChains(args, benchmarkChains, benchmark.sampleRate, benchmark.blockSize))
+            {
+                benchmark.run(chains);
+                quit();
+            }
+            return;
+        }
+
+        // Creates the built-in types (ALSA, JACK...) before adding ours, the manager skips that once the list is not empty
+        deviceManager.getAvailableDeviceTypes();
+        deviceManager.addAudioDeviceType(std::make_unique<NullAudioIODeviceType>(inputFile, outputFile, args.containsOption("--freewheel")));
+
+        if (deviceType.isNotEmpty())
+            deviceManager.setCurrentAudioDeviceType(deviceType, false);
+
+        juce::AudioDeviceManager::AudioDeviceSetup setup;
+        setup.inputDeviceName = deviceName;
+        setup.outputDeviceName = deviceName;
+        setup.sampleRate = sampleRate;
+        setup.bufferSize = bufferSize;
+
+        const auto error = deviceManager.initialise(2 * requestedChains, 2 * requestedChains, nullptr, false, {}, &setup);
+        auto* device = deviceManager.getCurrentAudioDevice();
+
+        if (error.isNotEmpty() || device == nullptr)
+        {
+            fail("Cannot open audio device: " + (error.isNotEmpty() ? error : juce::String("none available")));
+            return;
+        }
+
+        // Chain i needs the output pair 2i, 2i + 1, so the device decides how many chains can run.
+        // A mono device still runs one chain, the engine drops the channel it doesn't have
+        const int numOutputs = device->getActiveOutputChannels().countNumberOfSetBits();
+
+        if (numOutputs == 0)
+        {
+            fail("Cannot run: " + device->getName() + " has no active output channel");
+            return;
+        }
+
+        const int numChains = juce::jmin(requestedChains, juce::jmax(1, numOutputs / 2));
+
+        if (numChains < requestedChains)
+            std::cout << "--chains " << requestedChains << " reduced to " << numChains << ": " << device->getName()
+                      << " has " << numOutputs << " output channels" << std::endl;
+
+        if (!loadChains(args, numChains, device->getCurrentSampleRate(), device->getCurrentBufferSizeSamples()))
+            return;
+
+        juce::Array<EffectChain*> chainsToRun;
+        for (auto* chain : chains)
+            chainsToRun.add(chain);
+
+        if (numChains > 1 && numWorkers > 0)
+            scheduler = std::make_unique<ChainScheduler>(juce::jmin(numWorkers, numChains - 1), priority);
+
+        engine = std::make_unique<RealtimeAudioEngine>(chainsToRun, priority, scheduler.get(),
+                                                       args.containsOption("--no-midi") ? nullptr : &midiCollector);
+        deviceManager.addAudioCallback(engine.get());
+
+        // Every keyboard plays the Synth of chain 0, like MIDIIn.connectAll did in Project.scd
+        juce::StringArray midiInputs;
+
+        if (!args.containsOption("--no-midi"))
+        {
+            for (auto& input : juce::MidiInput::getAvailableDevices())
+            {
+                deviceManager.setMidiInputDeviceEnabled(input.identifier, true);
+                midiInputs.add(input.name);
+            }
+
+            deviceManager.addMidiInputDeviceCallback({}, &midiCollector);
+        }
+
+        memoryLocked = !args.containsOption("--no-mlock") && Realtime::lockMemory();
+
+        std::cout << "Running " << numChains << " x " << chains[0]->getPluginNames().joinIntoString(" -> ")
+                  << (scheduler != nullptr ? " on " + juce::String(scheduler->getNumWorkers()) + " workers + the audio thread" : juce::String())
+                  << ", " << device->getTypeName() << " / " << device->getName() << " at "
+                  << device->getCurrentSampleRate() << " Hz, " << device->getCurrentBufferSizeSamples()
+                  << " samples, MIDI from " << (midiInputs.isEmpty() ? juce::String("nothing") : midiInputs.joinIntoString(", "))
+                  << std::endl;
+
+        if (latencyReport)
+        {
+            const double reportSeconds = seconds > 0.0 ? seconds : 10.0;
+            juce::Timer::callAfterDelay((int) (reportSeconds * 1000.0), [this] { printLatencyReport(); quit(); });
+        }
+        else if (seconds > 0.0)
+        {
+            juce::Timer::callAfterDelay((int) (seconds * 1000.0), [this] { quit(); });
+        }
+    }
+
+    void shutdown() override
+    {
+        deviceManager.removeMidiInputDeviceCallback({}, &midiCollector);
+
+        if (engine != nullptr)
+            deviceManager.removeAudioCallback(engine.get());
+
+        deviceManager.closeAudioDevice();
+        engine = nullptr;
+        scheduler = nullptr;
+    }
+
+    void systemRequestedQuit() override
+    {
+        quit();
+    }
+
+    void anotherInstanceStarted(const juce::String&) override {}
+
+private:
+    bool loadChains(const juce::ArgumentList& args, int numChains, double sampleRate, int blockSize)
+    {
+        jassert(numChains > 0); // Everything after loading expects chains[0]
+
+        juce::Array<juce::File> pluginFiles;
+
+        // Accepts both "--plugin PATH" and "--plugin=PATH", in chain order
+        for (int i = 0; i < args.size(); ++i)
+        {
+            const auto& arg = args.arguments.getReference(i);
+            juce::String path;
+
+            if (arg.text == "--plugin" && i + 1 < args.size())
+                path = args.arguments.getReference(++i).text;
+            else if (arg.isLongOption("plugin"))
+                path = arg.getLongOptionValue();
+
+            if (path.isNotEmpty())
+                pluginFiles.add(juce::File::getCurrentWorkingDirectory().getChildFile(path.unquoted()));
+        }
+
+        if (pluginFiles.isEmpty())
+        {
+            // Default chain from the folder where the VST3 builds are copied
+            const auto folder = juce::File::getSpecialLocation(juce::File::userHomeDirectory).getChildFile(".vst3");
+
+            // A chain without one of them would run without complaint but, say, never feed the Visualizer
+            for (auto& name : EffectChain::getDefaultPluginNames())
+            {
+                const auto file = folder.getChildFile(name + ".vst3");
+
+                if (!file.exists())
+                    return fail("Missing plugin " + file.getFullPathName() + ": copy the VST3 builds to "
+                                + folder.getFullPathName() + " or pass the chain with --plugin PATH");
+
+                pluginFiles.add(file);
+            }
+        }
+
+        if (pluginFiles.isEmpty())
+            return fail("No plugins to load: pass them with --plugin PATH");
+
+        // Every station gets its own plugin instances, which read their station number when created
+        for (int i = 0; i < numChains; ++i)
+        {
+            setStation(i);
+
+            juce::String error;
+            if (!chains.add(new EffectChain())->load(pluginFiles, sampleRate, blockSize, error))
+                return fail(error);
+        }
+
+        return true;
+    }
+
+    // See Shared/Station.h: chain i listens on the OSC ports of station i and only chain 0 feeds the Visualizer
+    static void setStation(int station)
+    {
+        const auto value = juce::String(station);
+
+       #if JUCE_WINDOWS
+        _putenv_s(Station::environmentVariable, value.toRawUTF8());
+       #else
+        setenv(Station::environmentVariable, value.toRawUTF8(), 1);
+       #endif
+    }
+
+    void printLatencyReport()
+    {
+        auto* device = deviceManager.getCurrentAudioDevice();
+        if (device == nullptr || engine == nullptr)
+            return;
+
+        const double sampleRate = device->getCurrentSampleRate();
+        const int bufferSize = device->getCurrentBufferSizeSamples();
+        const int inputLatency = device->getInputLatencyInSamples();
+        const int outputLatency = device->getOutputLatencyInSamples();
+        const int chainLatency = chains[0]->getLatencySamples();
+        const int total = inputLatency + outputLatency + chainLatency;
+        const auto stats = engine->getStats();
+
+        auto ms = [sampleRate](int samples) { return juce::String(1000.0 * samples / sampleRate, 2) + " ms"; };
+
+        std::cout << "\nLatency report\n"
+                  << "  device            " << device->getTypeName() << " / " << device->getName() << "\n"
+                  << "  chains            " << chains.size() << " (" << (scheduler != nullptr ? scheduler->getNumWorkers() : 0) << " workers)\n"
+                  << "  sample rate       " << sampleRate << " Hz\n"
+                  << "  buffer            " << bufferSize << " samples (" << ms(bufferSize) << ")\n"
+                  << "  input latency     " << inputLatency << " samples (" << ms(inputLatency) << ")\n"
+                  << "  output latency    " << outputLatency << " samples (" << ms(outputLatency) << ")\n"
+                  << "  plugin latency    " << chainLatency << " samples (" << ms(chainLatency) << ")\n"
+                  << "  round trip        " << total << " samples (" << ms(total) << ")\n"
+                  << "  callbacks         " << stats.callbacks << "\n"
+                  << "  callback mean     " << juce::String(stats.meanMicros, 1) << " us ("
+                  << juce::String(stats.deadlineMicros > 0.0 ? 100.0 * stats.meanMicros / stats.deadlineMicros : 0.0, 1) << "% of "
+                  << juce::String(stats.deadlineMicros, 1) << " us)\n"
+                  << "  callback max      " << juce::String(stats.maxMicros, 1) << " us\n"
+                  << "  over deadline     " << stats.overruns << "\n"
+                  << "  device xruns      " << device->getXRunCount() << "\n"
+                  << "  realtime thread   " << (engine->isRealtime() ? "yes" : "no (check rtprio limits)") << "\n"
+                  << "  memory locked     " << (memoryLocked ? "yes" : "no (check memlock limits)") << std::endl;
+    }
+
+    bool fail(const juce::String& message)
+    {
+        std::cerr << message << std::endl;
+        setApplicationReturnValue(1);
+        quit();
+        return false;
+    }
+
+    static void printUsage()
+    {
+        std::cout << "Usage: Engine [options]\n"
+                  << "  --device-type TYPE   ALSA, JACK or Null (default: first available)\n"
+                  << "  --device NAME        device name (default: the type's default device)\n"
+                  << "  --buffer N           buffer size in samples, e.g. 32 or 64\n"
+                  << "  --rate HZ            sample rate\n"
+                  << "  --plugin PATH        VST3 to load, repeat in chain order (default: ~/.vst3/"
+                  << EffectChain::getDefaultPluginNames().joinIntoString(".vst3, ") << ".vst3)\n"
+                  << "  --chains N           independent chains, chain i uses device channels 2i and 2i+1 and the OSC ports\n"
+                  << "                       of station i, 9001 + 10i... (default 1, at most half the output channels)\n"
+                  << "  --workers N          real time worker threads running chains in parallel (default: cores - 1)\n"
+                  << "  --benchmark [N]      time 1 to N chains in series and in parallel on a Null device, then exit\n"
+                  << "  --denormal-test [S]  note and impulse then S s of silence (default 30) through one chain on a Null\n"
+                  << "                       device, with and without host FTZ/DAZ, exit 1 if the plugins let denormals\n"
+                  << "                       slow the quiet tail down\n"
+                  << "  --osc-benchmark [S]  packets per second of juce_osc and OscCodec, S seconds per test (--buffer sets\n"
+                  << "                       the /waveform block size), then exit\n"
+                  << "  --no-midi            do not open the MIDI inputs (default: all of them play the Synth of chain 0)\n"
+                  << "  --rt-priority N      SCHED_FIFO priority of the audio and worker threads (default 80)\n"
+                  << "  --no-mlock           do not lock the engine memory\n"
+                  << "  --input FILE         Null device: audio file used as input\n"
+                  << "  --output FILE        Null device: WAV file receiving the output\n"
+                  << "  --freewheel          Null device: run as fast as possible\n"
+                  << "  --seconds S          stop after S seconds\n"
+                  << "  --latency-report     print device, plugin and callback timings, then exit (after --seconds or 10 s)"
+                  << std::endl;
+    }
+
+    juce::OwnedArray<EffectChain> chains;
+    std::unique_ptr<ChainScheduler> scheduler;
+    std::unique_ptr<RealtimeAudioEngine> engine;
+    juce::AudioDeviceManager deviceManager;
+    juce::MidiMessageCollector midiCollector;
+    bool memoryLocked = false;
+};
+
+START_JUCE_APPLICATION(EngineApplication)
@@ -0,0 +1,154 @@
+#include "NullAudioDevice.h"
+
+NullAudioIODevice::NullAudioIODevice(const juce::File& inputFileToUse, const juce::File& outputFileToUse, bool freewheelToUse)
+    : AudioIODevice("Null", "Null"),
+      Thread("Null audio device"),
+      inputFile(inputFileToUse),
+      outputFile(outputFileToUse),
+      freewheel(freewheelToUse)
+{
+    formatManager.registerBasicFormats();
+}
+
+NullAudioIODevice::~NullAudioIODevice()
+{
+    close();
+}
+
+juce::String NullAudioIODevice::open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                                     double sampleRate, int bufferSizeSamples)
+{
+    close();
+
+    currentSampleRate = sampleRate > 0.0 ? sampleRate : 48000.0;
+    bufferSize = bufferSizeSamples > 0 ? bufferSizeSamples : getDefaultBufferSize();
+    activeInputs = inputChannels;
+    activeInputs.setRange(maxChannels, activeInputs.getHighestBit() + 1, false);
+    activeOutputs = outputChannels;
+    activeOutputs.setRange(maxChannels, activeOutputs.getHighestBit() + 1, false);
+
+    // Active channels are passed densely to the callback, keep at least a stereo pair for the file I/O
+    inputBuffer.setSize(juce::jmax(2, activeInputs.countNumberOfSetBits()), bufferSize);
+    outputBuffer.setSize(juce::jmax(2, activeOutputs.countNumberOfSetBits()), bufferSize);
+    readPosition = 0;
+    lateBlocks = 0;
+
+    if (inputFile != juce::File())
+    {
+        reader.reset(formatManager.createReaderFor(inputFile));
+        if (reader == nullptr)
+            return lastError = "Cannot read " + inputFile.getFullPathName();
+    }
+
+    if (outputFile != juce::File())
+    {
+        outputFile.deleteFile();
+        auto stream = std::make_unique<juce::FileOutputStream>(outputFile);
+        std::unique_ptr<juce::AudioFormatWriter> wavWriter;
+
+        if (stream->openedOk())
+            wavWriter.reset(juce::WavAudioFormat().createWriterFor(stream.get(), currentSampleRate, 2, 24, {}, 0));
+
+        if (wavWriter == nullptr)
+            return lastError = "Cannot write " + outputFile.getFullPathName();
+
+        stream.release(); // Now owned by the writer
+
+        // Four seconds of FIFO between the device thread and the disk
+        writerThread.startThread();
+        writer = std::make_unique<juce::AudioFormatWriter::ThreadedWriter>(wavWriter.release(), writerThread,
+                                                                           (int) (4.0 * currentSampleRate));
+    }
+
+    opened = true;
+    return lastError = {};
+}
+
+juce::StringArray NullAudioIODevice::getChannelNames()
+{
+    juce::StringArray names;
+    for (int pair = 1; pair <= maxChannels / 2; ++pair)
+        names.add("Left " + juce::String(pair), "Right " + juce::String(pair));
+    return names;
+}
+
+void NullAudioIODevice::close()
+{
+    stop();
+    reader.reset();
+    writer.reset(); // Flushes what is left in the FIFO
+    writerThread.stopThread(2000);
+    opened = false;
+}
+
+void NullAudioIODevice::start(juce::AudioIODeviceCallback* newCallback)
+{
+    if (!opened || newCallback == nullptr || isThreadRunning())
+        return;
+
+    callback = newCallback;
+    callback->audioDeviceAboutToStart(this);
+    startThread(juce::Thread::Priority::highest);
+}
+
+void NullAudioIODevice::stop()
+{
+    if (!isThreadRunning())
+        return;
+
+    stopThread(2000);
+
+    if (callback != nullptr)
+        callback->audioDeviceStopped();
+
+    callback = nullptr;
+}
+
+void NullAudioIODevice::run()
+{
+    const int numInputs = activeInputs.countNumberOfSetBits();
+    const int numOutputs = activeOutputs.countNumberOfSetBits();
+    const double blockMs = 1000.0 * bufferSize / currentSampleRate;
+    double nextBlockMs = juce::Time::getMillisecondCounterHiRes();
+
+    while (!threadShouldExit())
+    {
+        inputBuffer.clear();
+        outputBuffer.clear();
+
+        if (reader != nullptr)
+        {
+            reader->read(&inputBuffer, 0, bufferSize, readPosition, true, true);
+            readPosition += bufferSize;
+
+            for (int ch = 2; ch < inputBuffer.getNumChannels(); ++ch)
+                inputBuffer.copyFrom(ch, 0, inputBuffer, ch % 2, 0, bufferSize);
+        }
+
+        callback->audioDeviceIOCallbackWithContext(inputBuffer.getArrayOfReadPointers(), numInputs,
+                                                   outputBuffer.getArrayOfWritePointers(), numOutputs,
+                                                   bufferSize, {});
+
+        if (writer != nullptr)
+        {
+            // Freewheeling can outrun the disk, wait for room then. A real time pace drops the block instead
+            while (!writer->write(outputBuffer.getArrayOfReadPointers(), bufferSize) && freewheel && !threadShouldExit())
+                juce::Thread::sleep(1);
+        }
+
+        if (freewheel)
+            continue;
+
+        // Keep the long term pace of a real device, blocks that finish late are counted as xruns
+        nextBlockMs += blockMs;
+        const double waitMs = nextBlockMs - juce::Time::getMillisecondCounterHiRes();
+
+        if (waitMs >= 1.0)
+            wait((int) waitMs);
+        else if (waitMs < -blockMs)
+        {
+            ++lateBlocks;
+            nextBlockMs = juce::Time::getMillisecondCounterHiRes();
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Device without hardware, for tests and benchmarks: a thread calls the engine at the pace of a real
+// device (or as fast as possible when freewheeling), reading its input from an optional audio file
+// (copied to every stereo pair) and writing the first output pair to an optional WAV file. The file is
+// written by a background thread, the device thread only copies each block into a FIFO
+class NullAudioIODevice : public juce::AudioIODevice,
+                          private juce::Thread
+{
+public:
+    NullAudioIODevice(const juce::File& inputFileToUse, const juce::File& outputFileToUse, bool freewheelToUse);
+    ~NullAudioIODevice() override;
+
+    static constexpr int maxChannels = 32;
+
+    juce::StringArray getOutputChannelNames() override { return getChannelNames(); }
+    juce::StringArray getInputChannelNames() override  { return getChannelNames(); }
+    juce::Array<double> getAvailableSampleRates() override { return { 44100.0, 48000.0, 88200.0, 96000.0 }; }
+    juce::Array<int> getAvailableBufferSizes() override { return { 16, 32, 64, 128, 256, 512, 1024 }; }
+    int getDefaultBufferSize() override { return 64; }
+
+    juce::String open(const juce::BigInteger& inputChannels, const juce::BigInteger& outputChannels,
+                      double sampleRate, int bufferSizeSamples) override;
+    void close() override;
+    bool isOpen() override { return opened; }
+
+    void start(juce::AudioIODeviceCallback* callback) override;
+    void stop() override;
+    bool isPlaying() override { return isThreadRunning(); }
+
+    juce::String getLastError() override { return lastError; }
+    int getCurrentBufferSizeSamples() override { return bufferSize; }
+    double getCurrentSampleRate() override { return currentSampleRate; }
+    int getCurrentBitDepth() override { return 32; }
+    juce::BigInteger getActiveOutputChannels() const override { return activeOutputs; }
+    juce::BigInteger getActiveInputChannels() const override  { return activeInputs; }
+    int getOutputLatencyInSamples() override { return 0; }
+    int getInputLatencyInSamples() override  { return 0; }
+    int getXRunCount() const noexcept override { return lateBlocks.load(); }
+
+private:
+    void run() override;
+    static juce::StringArray getChannelNames();
+
+    const juce::File inputFile, outputFile;
+    const bool freewheel;
+
+    juce::AudioFormatManager formatManager;
+    std::unique_ptr<juce::AudioFormatReader> reader;
+    juce::TimeSliceThread writerThread { "Null audio device writer" };
+    std::unique_ptr<juce::AudioFormatWriter::ThreadedWriter> writer;
+    juce::int64 readPosition = 0;
+
+    juce::AudioIODeviceCallback* callback = nullptr;
+    juce::AudioBuffer<float> inputBuffer, outputBuffer;
+    juce::BigInteger activeInputs, activeOutputs;
+    double currentSampleRate = 48000.0;
+    int bufferSize = 64;
+    std::atomic<int> lateBlocks { 0 };
+    bool opened = false;
+    juce::String lastError;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NullAudioIODevice)
+};
+
+//==============================================================================
+// Registers the device above as the "Null" device type of the AudioDeviceManager
+class NullAudioIODeviceType : public juce::AudioIODeviceType
+{
+public:
+    NullAudioIODeviceType(const juce::File& inputFileToUse, const juce::File& outputFileToUse, bool freewheelToUse)
+        : AudioIODeviceType("Null"), inputFile(inputFileToUse), outputFile(outputFileToUse), freewheel(freewheelToUse) {}
+
+    void scanForDevices() override {}
+    juce::StringArray getDeviceNames(bool) const override { return { "Null" }; }
+    int getDefaultDeviceIndex(bool) const override { return 0; }
+    int getIndexOfDevice(juce::AudioIODevice* device, bool) const override { return device != nullptr ? 0 : -1; }
+    bool hasSeparateInputsAndOutputs() const override { return false; }
+
+    juce::AudioIODevice* createDevice(const juce::String&, const juce::String&) override
+    {
+        return new NullAudioIODevice(inputFile, outputFile, freewheel);
+    }
+
+private:
+    const juce::File inputFile, outputFile;
+    const bool freewheel;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(NullAudioIODeviceType)
+};
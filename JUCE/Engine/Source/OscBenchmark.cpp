@@ -0,0 +1,245 @@
+#include "OscBenchmark.h"
+#include "../../Shared/OscCodec.h"
+#include <atomic>
+#include <iostream>
+#include <thread>
+
+namespace
+{
+    using WaveformPacket = OscCodec::Writer<>;
+    using ControlPacket = OscCodec::Writer<64, 4>;
+
+    const juce::String localHost { "127.0.0.1" };
+
+    // Calls sendOne in batches until the time is up
+    template <typename Function>
+    double packetsPerSecond(double seconds, Function&& sendOne)
+    {
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        juce::uint64 packets = 0;
+        double elapsed = 0.0;
+
+        do
+        {
+            for (int i = 0; i < 64; ++i)
+                sendOne();
+
+            packets += 64;
+            elapsed = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+        }
+        while (elapsed < seconds);
+
+        return (double) packets / elapsed;
+    }
+
+    // Floods the port with one packet from another thread and counts what the receiver delivered
+    double receivedPerSecond(int port, const char* data, size_t size,
+                             const std::atomic<juce::uint64>& received, double seconds)
+    {
+        std::atomic<bool> stop { false };
+
+        std::thread flood([&]
+        {
+            juce::DatagramSocket socket;
+
+            while (!stop.load(std::memory_order_relaxed))
+                socket.write(localHost, port, data, (int) size);
+        });
+
+        juce::Thread::sleep(100); // Let both threads get going
+
+        const auto before = received.load();
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        juce::Thread::sleep((int) (seconds * 1000.0));
+        const auto count = received.load() - before;
+        const auto elapsed = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+        stop = true;
+        flood.join();
+        return (double) count / elapsed;
+    }
+
+    int findFreePort()
+    {
+        juce::DatagramSocket probe;
+        probe.bindToPort(0);
+        return probe.getBoundPort();
+    }
+
+    // Both listeners read every float of the message, as a receiver of /waveform has to
+    struct JuceCounter : juce::OSCReceiver::Listener<juce::OSCReceiver::RealtimeCallback>
+    {
+        void oscMessageReceived(const juce::OSCMessage& message) override
+        {
+            for (const auto& argument : message)
+                if (argument.isFloat32())
+                    sum += argument.getFloat32();
+
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::atomic<juce::uint64> received { 0 };
+        float sum = 0.0f;
+    };
+
+    struct CodecCounter : OscCodec::Receiver::Listener
+    {
+        void oscMessageReceived(const OscCodec::MessageView& message) override
+        {
+            for (auto arguments = message.getArguments(); !arguments.atEnd();)
+            {
+                if (arguments.isFloat32())
+                    sum += arguments.readFloat32();
+                else
+                    arguments.skip();
+            }
+
+            received.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::atomic<juce::uint64> received { 0 };
+        float sum = 0.0f;
+    };
+
+    juce::String column(const juce::String& text, int width)
+    {
+        return text.paddedLeft(' ', width);
+    }
+
+    void printRow(const juce::String& name, double juceRate, double codecRate)
+    {
+        const double ratio = juceRate > 0.0 ? codecRate / juceRate : 0.0;
+
+        std::cout << name.paddedRight(' ', 20)
+                  << column(juce::String(juceRate, 0), 14)
+                  << column(juce::String(codecRate, 0), 14)
+                  << column(juce::String(ratio, 1) + "x", 9) << std::endl;
+    }
+}
+
+void OscBenchmark::run() const
+{
+    // One block of a sine per channel, the content doesn't matter to either codec
+    juce::AudioBuffer<float> block(2, samplesPerChannel);
+
+    for (int ch = 0; ch < block.getNumChannels(); ++ch)
+        for (int i = 0; i < samplesPerChannel; ++i)
+            block.setSample(ch, i, std::sin((float) i * 0.05f));
+
+    auto buildJuceWaveform = [&]
+    {
+        juce::OSCMessage message("/waveform");
+        message.addInt32(block.getNumChannels());
+        message.addInt32(samplesPerChannel);
+
+        for (int ch = 0; ch < block.getNumChannels(); ++ch)
+            for (int i = 0; i < samplesPerChannel; ++i)
+                message.addFloat32(block.getSample(ch, i));
+
+        return message;
+    };
+
+    auto buildJuceDrive = []
+    {
+        juce::OSCMessage message("/drive");
+        message.addFloat32(0.5f);
+        return message;
+    };
+
+    // About 80 KB, kept off the stack
+    auto waveform = std::make_unique<WaveformPacket>();
+    ControlPacket drive;
+
+    auto buildCodecWaveform = [&]
+    {
+        waveform->clear();
+        waveform->beginMessage("/waveform");
+        waveform->addInt32(block.getNumChannels());
+        waveform->addInt32(samplesPerChannel);
+
+        for (int ch = 0; ch < block.getNumChannels(); ++ch)
+            waveform->addFloat32s(block.getReadPointer(ch), samplesPerChannel);
+
+        waveform->endMessage();
+    };
+
+    auto buildCodecDrive = [&]
+    {
+        drive.clear();
+        drive.beginMessage("/drive");
+        drive.addFloat32(0.5f);
+        drive.endMessage();
+    };
+
+    std::cout << "OSC benchmark: " << secondsPerTest << " s per test, /waveform with 2 x " << samplesPerChannel
+              << " samples, packets per second on 127.0.0.1\n"
+              << juce::String("test").paddedRight(' ', 20) << column("juce_osc", 14) << column("OscCodec", 14)
+              << column("ratio", 9) << std::endl;
+
+    // The JUCE figure leaves out the serialisation, which only happens inside OSCSender::send
+    size_t checksum = 0;
+
+    printRow("build /waveform",
+             packetsPerSecond(secondsPerTest, [&] { checksum += (size_t) buildJuceWaveform().size(); }),
+             packetsPerSecond(secondsPerTest, [&] { buildCodecWaveform(); checksum += waveform->getSize(); }));
+
+    // Sending to a socket that never reads, the kernel drops what doesn't fit
+    {
+        juce::DatagramSocket sink;
+        sink.bindToPort(0);
+        const int port = sink.getBoundPort();
+
+        juce::OSCSender sender;
+        sender.connect(localHost, port);
+
+        juce::DatagramSocket socket;
+        socket.bindToPort(0);
+
+        printRow("send /waveform",
+                 packetsPerSecond(secondsPerTest, [&] { sender.send(buildJuceWaveform()); }),
+                 packetsPerSecond(secondsPerTest, [&]
+                 {
+                     buildCodecWaveform();
+                     socket.write(localHost, port, waveform->getData(), (int) waveform->getSize());
+                 }));
+
+        printRow("send /drive",
+                 packetsPerSecond(secondsPerTest, [&] { sender.send(buildJuceDrive()); }),
+                 packetsPerSecond(secondsPerTest, [&]
+                 {
+                     buildCodecDrive();
+                     socket.write(localHost, port, drive.getData(), (int) drive.getSize());
+                 }));
+    }
+
+    // Both receivers get the same bytes, which is what juce::OSCSender puts on the wire too
+    {
+        JuceCounter juceCounter;
+        juce::OSCReceiver juceReceiver;
+        const int jucePort = findFreePort();
+        juceReceiver.connect(jucePort);
+        juceReceiver.addListener(&juceCounter);
+
+        CodecCounter codecCounter;
+        OscCodec::Receiver codecReceiver;
+        const int codecPort = findFreePort();
+        codecReceiver.connect(codecPort, codecCounter);
+
+        buildCodecWaveform();
+        buildCodecDrive();
+
+        printRow("receive /waveform",
+                 receivedPerSecond(jucePort, waveform->getData(), waveform->getSize(), juceCounter.received, secondsPerTest),
+                 receivedPerSecond(codecPort, waveform->getData(), waveform->getSize(), codecCounter.received, secondsPerTest));
+
+        printRow("receive /drive",
+                 receivedPerSecond(jucePort, drive.getData(), drive.getSize(), juceCounter.received, secondsPerTest),
+                 receivedPerSecond(codecPort, drive.getData(), drive.getSize(), codecCounter.received, secondsPerTest));
+
+        juceReceiver.removeListener(&juceCounter);
+        juceReceiver.disconnect();
+        codecReceiver.disconnect();
+    }
+
+    juce::ignoreUnused(checksum);
+}
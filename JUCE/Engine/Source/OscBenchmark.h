@@ -0,0 +1,13 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Packets per second of the JUCE OSC classes against Shared/OscCodec.h on the loopback interface:
+// building the /waveform stream, sending /waveform and /drive, and receiving them
+struct OscBenchmark
+{
+    double secondsPerTest = 1.0;
+    int samplesPerChannel = 512; // Stereo /waveform blocks, as sent by OSCSender
+
+    void run() const;
+};
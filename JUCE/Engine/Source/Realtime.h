@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+#if JUCE_LINUX || JUCE_BSD
+ #include <pthread.h>
+ #include <sched.h>
+ #include <sys/mman.h>
+#endif
+
+// Small OS helpers for the engine threads. Both need the matching limits on Linux
+// (rtprio and memlock in /etc/security/limits.conf, or CAP_SYS_NICE / CAP_IPC_LOCK)
+namespace Realtime
+{
+    // Moves the calling thread to SCHED_FIFO with the given priority (1-99)
+    inline bool promoteCurrentThread(int priority)
+    {
+       #if JUCE_LINUX || JUCE_BSD
+        sched_param param {};
+        param.sched_priority = juce::jlimit(sched_get_priority_min(SCHED_FIFO),
+                                            sched_get_priority_max(SCHED_FIFO), priority);
+        return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+       #else
+        juce::ignoreUnused(priority);
+        return false;
+       #endif
+    }
+
+    // Locks the pages mapped so far (code, plugins, preallocated buffers) so the audio thread
+    // never waits on a page fault. Call it once everything has been loaded and prepared
+    inline bool lockMemory()
+    {
+       #if JUCE_LINUX || JUCE_BSD
+        return mlockall(MCL_CURRENT) == 0;
+       #else
+        return false;
+       #endif
+    }
+}
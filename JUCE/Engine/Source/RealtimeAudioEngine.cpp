@@ -0,0 +1,146 @@
+#include "RealtimeAudioEngine.h"
+#include "Realtime.h"
+
+RealtimeAudioEngine::RealtimeAudioEngine(const juce::Array<EffectChain*>& chainsToUse, int realtimePriorityToUse,
+                                         ChainScheduler* schedulerToUse, juce::MidiMessageCollector* midiInputToUse)
+    : chains(chainsToUse), realtimePriority(realtimePriorityToUse), scheduler(schedulerToUse), midiInput(midiInputToUse)
+{
+}
+
+void RealtimeAudioEngine::audioDeviceAboutToStart(juce::AudioIODevice* device)
+{
+    sampleRate = device->getCurrentSampleRate();
+    blockSize = device->getCurrentBufferSizeSamples();
+
+    buffers.resize((size_t) chains.size());
+    midiBlock.ensureSize(2048);
+
+    if (midiInput != nullptr)
+        midiInput->reset(sampleRate);
+
+    for (int c = 0; c < chains.size(); ++c)
+    {
+        buffers[(size_t) c].setSize(numChannels, blockSize);
+        chains[c]->prepare(sampleRate, blockSize);
+    }
+
+    // The device may hand the callback to a new thread after a restart
+    promotionAttempted = false;
+    callbacks = 0;
+    overruns = 0;
+    totalTicks = 0;
+    maxTicks = 0;
+}
+
+void RealtimeAudioEngine::audioDeviceStopped()
+{
+    for (auto* chain : chains)
+        chain->release();
+}
+
+void RealtimeAudioEngine::perform(int chainIndex) noexcept
+{
+    // Denormal flushing is per thread, the workers need it as much as the audio thread
+    juce::ScopedNoDenormals noDenormals;
+
+    // Refers to the preallocated channels, no allocation for a stereo buffer
+    juce::AudioBuffer<float> block(buffers[(size_t) chainIndex].getArrayOfWritePointers(), numChannels, currentChunk);
+
+    if (chainIndex == 0 && midiInput != nullptr)
+        chains[chainIndex]->process(block, midiBlock);
+    else
+        chains[chainIndex]->process(block);
+}
+
+void RealtimeAudioEngine::audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannels,
+                                                           float* const* outputChannelData, int numOutputChannels,
+                                                           int numSamples, const juce::AudioIODeviceCallbackContext&)
+{
+    juce::ScopedNoDenormals noDenormals;
+    const auto start = juce::Time::getHighResolutionTicks();
+
+    if (!promotionAttempted)
+    {
+        promotionAttempted = true;
+        realtimeScheduling = Realtime::promoteCurrentThread(realtimePriority);
+    }
+
+    const int numChains = chains.size();
+
+    // Devices may deliver more samples than announced, process those in chunks of our buffer size
+    for (int offset = 0; offset < numSamples;)
+    {
+        currentChunk = juce::jmin(numSamples - offset, blockSize);
+
+        // Chain c reads and writes the device channels 2c and 2c + 1
+        for (int c = 0; c < numChains; ++c)
+        {
+            for (int ch = 0; ch < numChannels; ++ch)
+            {
+                const int deviceChannel = c * numChannels + ch;
+
+                if (deviceChannel < numInputChannels && inputChannelData[deviceChannel] != nullptr)
+                    buffers[(size_t) c].copyFrom(ch, 0, inputChannelData[deviceChannel] + offset, currentChunk);
+                else
+                    buffers[(size_t) c].clear(ch, 0, currentChunk);
+            }
+        }
+
+        // Timestamped by the collector, so each note lands on its sample within the chunk
+        if (midiInput != nullptr)
+            midiInput->removeNextBlockOfMessages(midiBlock, currentChunk);
+
+        if (scheduler != nullptr && numChains > 1)
+            scheduler->process(*this, numChains);
+        else
+            for (int c = 0; c < numChains; ++c)
+                perform(c);
+
+        for (int deviceChannel = 0; deviceChannel < numOutputChannels; ++deviceChannel)
+        {
+            if (outputChannelData[deviceChannel] == nullptr)
+                continue;
+
+            const int c = deviceChannel / numChannels;
+
+            if (c < numChains)
+                juce::FloatVectorOperations::copy(outputChannelData[deviceChannel] + offset,
+                                                  buffers[(size_t) c].getReadPointer(deviceChannel % numChannels), currentChunk);
+            else
+                juce::FloatVectorOperations::clear(outputChannelData[deviceChannel] + offset, currentChunk);
+        }
+
+        offset += currentChunk;
+    }
+
+    // Only this thread writes the statistics, the report reads them from the message thread
+    const auto elapsed = juce::Time::getHighResolutionTicks() - start;
+    const auto deadline = (juce::int64) ((double) numSamples / sampleRate * (double) juce::Time::getHighResolutionTicksPerSecond());
+
+    callbacks.store(callbacks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    totalTicks.store(totalTicks.load(std::memory_order_relaxed) + elapsed, std::memory_order_relaxed);
+
+    if (elapsed > maxTicks.load(std::memory_order_relaxed))
+        maxTicks.store(elapsed, std::memory_order_relaxed);
+
+    if (elapsed > deadline)
+        overruns.store(overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+RealtimeAudioEngine::Stats RealtimeAudioEngine::getStats() const
+{
+    Stats stats;
+    const double microsPerTick = 1.0e6 / (double) juce::Time::getHighResolutionTicksPerSecond();
+
+    stats.callbacks = callbacks.load(std::memory_order_relaxed);
+    stats.overruns = overruns.load(std::memory_order_relaxed);
+    stats.maxMicros = (double) maxTicks.load(std::memory_order_relaxed) * microsPerTick;
+
+    if (stats.callbacks > 0)
+        stats.meanMicros = (double) totalTicks.load(std::memory_order_relaxed) * microsPerTick / (double) stats.callbacks;
+
+    if (sampleRate > 0.0)
+        stats.deadlineMicros = 1.0e6 * (double) blockSize / sampleRate;
+
+    return stats;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+#include "ChainScheduler.h"
+#include "EffectChain.h"
+
+// Device callback of the standalone engine: runs one effect chain per stereo pair of the device
+// (one per performer station), promotes the audio thread to real time scheduling on the first
+// callback and keeps lock-free timing statistics. With a scheduler the chains of a block run in
+// parallel on its workers, otherwise in series on the audio thread. The notes of the optional MIDI
+// input go to the first chain only, the station that owns the keyboard
+class RealtimeAudioEngine : public juce::AudioIODeviceCallback,
+                            private ChainScheduler::Job
+{
+public:
+    struct Stats
+    {
+        juce::uint64 callbacks = 0;
+        juce::uint64 overruns = 0;   // Callbacks that took longer than their own block duration
+        double meanMicros = 0.0;
+        double maxMicros = 0.0;
+        double deadlineMicros = 0.0; // Duration of one device buffer
+    };
+
+    RealtimeAudioEngine(const juce::Array<EffectChain*>& chainsToUse, int realtimePriorityToUse,
+                        ChainScheduler* schedulerToUse = nullptr, juce::MidiMessageCollector* midiInputToUse = nullptr);
+
+    void audioDeviceIOCallbackWithContext(const float* const* inputChannelData, int numInputChannels,
+                                          float* const* outputChannelData, int numOutputChannels,
+                                          int numSamples, const juce::AudioIODeviceCallbackContext& context) override;
+    void audioDeviceAboutToStart(juce::AudioIODevice* device) override;
+    void audioDeviceStopped() override;
+
+    Stats getStats() const;
+    bool isRealtime() const noexcept { return realtimeScheduling.load(std::memory_order_relaxed); }
+
+private:
+    void perform(int chainIndex) noexcept override;
+
+    static constexpr int numChannels = 2; // Per chain
+
+    const juce::Array<EffectChain*> chains;
+    const int realtimePriority;
+    ChainScheduler* scheduler;
+    juce::MidiMessageCollector* midiInput;
+
+    std::vector<juce::AudioBuffer<float>> buffers; // One per chain
+    juce::MidiBuffer midiBlock;                     // Notes of the current chunk, for chain 0
+    int blockSize = 0;
+    int currentChunk = 0;
+    double sampleRate = 0.0;
+    bool promotionAttempted = false;
+    std::atomic<bool> realtimeScheduling { false };
+
+    std::atomic<juce::uint64> callbacks { 0 }, overruns { 0 };
+    std::atomic<juce::int64> totalTicks { 0 }, maxTicks { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeAudioEngine)
+};
@@ -0,0 +1,69 @@
+#include "ScalingBenchmark.h"
+#include "ChainScheduler.h"
+#include "NullAudioDevice.h"
+#include "RealtimeAudioEngine.h"
+#include <iostream>
+
+namespace
+{
+    RealtimeAudioEngine::Stats measure(const juce::Array<EffectChain*>& chains, ChainScheduler* scheduler,
+                                       const ScalingBenchmark& settings)
+    {
+        RealtimeAudioEngine engine(chains, settings.realtimePriority, scheduler);
+        NullAudioIODevice device({}, {}, true);
+
+        juce::BigInteger channels;
+        channels.setRange(0, 2 * chains.size(), true);
+
+        const auto error = device.open(channels, channels, settings.sampleRate, settings.blockSize);
+        if (error.isNotEmpty())
+        {
+            std::cerr << error << std::endl;
+            return {};
+        }
+
+        device.start(&engine);
+
+        while (engine.getStats().callbacks < (juce::uint64) settings.numBlocks)
+            juce::Thread::sleep(10);
+
+        device.stop();
+        return engine.getStats();
+    }
+
+    juce::String column(const juce::String& text, int width)
+    {
+        return text.paddedLeft(' ', width);
+    }
+}
+
+void ScalingBenchmark::run(const juce::OwnedArray<EffectChain>& chains) const
+{
+    std::cout << "Scaling benchmark: " << numBlocks << " blocks of " << blockSize << " samples at " << sampleRate
+              << " Hz, " << numWorkers << " workers\n"
+              << column("chains", 6) << column("serial us", 12) << column("parallel us", 13)
+              << column("speedup", 9) << column("load", 8) << column("worst us", 10) << std::endl;
+
+    juce::Array<EffectChain*> subset;
+
+    for (auto* chain : chains)
+    {
+        subset.add(chain);
+
+        const auto serial = measure(subset, nullptr, *this);
+
+        // More workers than chains would only spin, the audio thread takes one chain itself
+        ChainScheduler scheduler(juce::jmin(numWorkers, subset.size() - 1), realtimePriority);
+        const auto parallel = measure(subset, &scheduler, *this);
+
+        const double speedup = parallel.meanMicros > 0.0 ? serial.meanMicros / parallel.meanMicros : 0.0;
+        const double load = parallel.deadlineMicros > 0.0 ? 100.0 * parallel.meanMicros / parallel.deadlineMicros : 0.0;
+
+        std::cout << column(juce::String(subset.size()), 6)
+                  << column(juce::String(serial.meanMicros, 1), 12)
+                  << column(juce::String(parallel.meanMicros, 1), 13)
+                  << column(juce::String(speedup, 2) + "x", 9)
+                  << column(juce::String(load, 1) + "%", 8)
+                  << column(juce::String(parallel.maxMicros, 1), 10) << std::endl;
+    }
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "EffectChain.h"
+
+// Measures the engine callback for 1 to chains.size() chains, in series on the audio thread and
+// in parallel on the chain scheduler, using a freewheeling Null device so no hardware is involved
+struct ScalingBenchmark
+{
+    int numWorkers = 0;
+    int realtimePriority = 80;
+    double sampleRate = 48000.0;
+    int blockSize = 64;
+    int numBlocks = 20000;
+
+    void run(const juce::OwnedArray<EffectChain>& chains) const;
+};
@@ -3,8 +3,7 @@
 
 FiltersAudioProcessor::FiltersAudioProcessor()
 {
-    this->OSCReceiver::connect(9001);
-    this->OSCReceiver::addListener(this);
+    oscReceiver.connect(oscPort, *this);
 
     // We initialize all filters as lowpass by default
     for (int ch = 0; ch < NUM_CHANNELS; ++ch)
@@ -16,8 +15,7 @@ FiltersAudioProcessor::FiltersAudioProcessor()
 
 FiltersAudioProcessor::~FiltersAudioProcessor()
 {
-    this->OSCReceiver::removeListener(this);
-    this->OSCReceiver::disconnect();
+    oscReceiver.disconnect();
 }
 
 void FiltersAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
@@ -31,10 +29,17 @@ void FiltersAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock
     {
         for (auto& filter : filters[ch])
             filter.prepare(spec);
+
+        appliedCutoffHz[ch].fill(0.0f);
     }
 }
 
 void FiltersAudioProcessor::releaseResources()
+{
+    resetFilters();
+}
+
+void FiltersAudioProcessor::resetFilters()
 {
     // Reset all filters
     for (int ch = 0; ch < NUM_CHANNELS; ++ch)
@@ -58,7 +63,24 @@ void FiltersAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
     const int numChannels = buffer.getNumChannels();
     const int numSamples = buffer.getNumSamples();
 
-    int activeCount = std::count(activeFilters.begin(), activeFilters.end(), true);
+    // Checked before the early return below, with no filter active bad input would pass straight through
+    if (DspSafety::containsNonFinite(buffer))
+    {
+        buffer.clear();
+        resetFilters();
+        return;
+    }
+
+    // One snapshot per block, so both channels run the same filters even if an OSC message lands meanwhile
+    std::array<bool, NUM_TYPES> active {};
+    std::array<float, NUM_TYPES> cutoff {};
+    for (int i = 0; i < NUM_TYPES; ++i)
+    {
+        active[i] = activeFilters[i].load(std::memory_order_relaxed);
+        cutoff[i] = cutoffHz[i].load(std::memory_order_relaxed);
+    }
+
+    int activeCount = std::count(active.begin(), active.end(), true);
     if (activeCount == 0)
         return; // No filter active
 
@@ -72,11 +94,11 @@ void FiltersAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
         // Apply every active filter to the current channel
         for (int i = 0; i < NUM_TYPES; ++i)
         {
-            if (activeFilters[i])
+            if (active[i])
             {
                 if (i == NOTCH)
                 {
-                    float centerFreq = cutoffHz[i]; // This will be the center frequency of our notch
+                    float centerFreq = cutoff[i]; // This will be the center frequency of our notch
                     // OPTION 1: This is a proportional approach, the filter is slimmer in the low end and wider in the high frequencies because it's 10% of the cutoff, the behaviour might be strance because it widens when the cutoff is increased
                     // float bandwidth = centerFreq * 0.1f;
                     // float lowCutoff = centerFreq - (bandwidth * 0.5f);
@@ -94,72 +116,99 @@ void FiltersAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce:
                     lowCutoff = std::max(20.0f, lowCutoff);
                     highCutoff = std::min(20000.0f, highCutoff);
                     
-                    filters[ch][LPF].setCutoffFrequency(lowCutoff);
+                    updateCutoff(ch, LPF, lowCutoff);
                     filters[ch][LPF].setType(juce::dsp::StateVariableTPTFilterType::lowpass);
                     filters[ch][LPF].process(juce::dsp::ProcessContextReplacing<float>(channelBlock));
 
-                    filters[ch][HPF].setCutoffFrequency(highCutoff);
+                    updateCutoff(ch, HPF, highCutoff);
                     filters[ch][HPF].setType(juce::dsp::StateVariableTPTFilterType::highpass);
                     filters[ch][HPF].process(juce::dsp::ProcessContextReplacing<float>(channelBlock));
                 }
                 else
                 {
-                    filters[ch][i].setCutoffFrequency(cutoffHz[i]);
+                    updateCutoff(ch, i, cutoff[i]);
                     filters[ch][i].setType(static_cast<juce::dsp::StateVariableTPTFilterType>(i));
                     filters[ch][i].process(juce::dsp::ProcessContextReplacing<float>(channelBlock));
                 }
             }
         }
     }
+
+    // A filter state can still blow up, see DspSafety.h
+    if (DspSafety::containsNonFinite(buffer))
+    {
+        buffer.clear();
+        resetFilters();
+    }
 }
 
-void FiltersAudioProcessor::oscMessageReceived(const juce::OSCMessage& message)
+// Runs on the OSC receiver thread. The /waveform stream of OSCSender also lands on this port,
+// the views let it be dropped without building a message with a thousand arguments
+void FiltersAudioProcessor::oscMessageReceived(const OscCodec::MessageView& message)
 {
-    if (message.getAddressPattern() == "/filter/active")
+    if (message.hasAddress("/filter/active"))
     {
-        if (message.size() == 2 && message[0].isString() && message[1].isInt32())
+        if (message.size() == 2 && message.isString(0) && message.isInt32(1))
         {
-            juce::String filterName = message[0].getString();
-            int active = message[1].getInt32();
+            const char* filterName = message.getString(0);
+            int active = message.getInt32(1);
 
             int idx = -1;
-            if (filterName == "LPF") idx = LPF;
-            else if (filterName == "HPF") idx = HPF;
-            else if (filterName == "BPF") idx = BPF;
-            else if (filterName == "NOTCH") idx = NOTCH;
+            if (std::strcmp(filterName, "LPF") == 0) idx = LPF;
+            else if (std::strcmp(filterName, "HPF") == 0) idx = HPF;
+            else if (std::strcmp(filterName, "BPF") == 0) idx = BPF;
+            else if (std::strcmp(filterName, "NOTCH") == 0) idx = NOTCH;
 
             if (idx != -1)
             {
-                activeFilters[idx] = (active != 0);
-
-                // Max 2 filter actives
+                // Max 2 filter actives, counted before the store so the audio thread never sees a third one
                 int count = 0;
-                for (bool a : activeFilters)
-                    if (a) ++count;
-                if (count > 2)
-                    activeFilters[idx] = false;
+                for (int i = 0; i < NUM_TYPES; ++i)
+                    if (i != idx && activeFilters[i].load()) ++count;
+                activeFilters[idx] = (active != 0 && count < 2);
             }
         }
     }
-    else if (message.getAddressPattern() == "/filter/cutoff")
+    else if (message.hasAddress("/filter/cutoff"))
     {
-        if (message.size() == 2 && message[0].isString() && message[1].isFloat32())
+        if (message.size() == 2 && message.isString(0) && message.isFloat32(1))
         {
-            juce::String filterName = message[0].getString();
-            float cutoffValue = message[1].getFloat32();
+            const char* filterName = message.getString(0);
+            float cutoffValue = message.getFloat32(1);
 
             int idx = -1;
-            if (filterName == "LPF") idx = LPF;
-            else if (filterName == "HPF") idx = HPF;
-            else if (filterName == "BPF") idx = BPF;
-            else if (filterName == "NOTCH") idx = NOTCH;
+            if (std::strcmp(filterName, "LPF") == 0) idx = LPF;
+            else if (std::strcmp(filterName, "HPF") == 0) idx = HPF;
+            else if (std::strcmp(filterName, "BPF") == 0) idx = BPF;
+            else if (std::strcmp(filterName, "NOTCH") == 0) idx = NOTCH;
 
             if (idx != -1)
-                cutoffHz[idx] = cutoffValue;
+            {
+                // A cutoff of 0 or NaN would blow up the SVF, keep the last good one instead
+                cutoffValue = DspSafety::sanitise(cutoffValue, 20.0f, 20000.0f, cutoffHz[idx].load());
+
+                if (cutoffConditioners[idx].process(cutoffValue, cutoffValue))
+                    cutoffHz[idx] = cutoffValue;
+
+                cutoffConditioners[idx].logStats("Filters", filterName);
+            }
         }
     }
 }
 
+void FiltersAudioProcessor::updateCutoff(int channel, int slot, float cutoff)
+{
+    // The SVF needs a cutoff between 0 and Nyquist
+    cutoff = juce::jlimit(20.0f, DspSafety::maxCutoff(spec.sampleRate), cutoff);
+
+    // Recomputing the coefficients is only needed when the cutoff moved
+    if (appliedCutoffHz[channel][slot] != cutoff)
+    {
+        filters[channel][slot].setCutoffFrequency(cutoff);
+        appliedCutoffHz[channel][slot] = cutoff;
+    }
+}
+
 juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter() // I don't actually know what the function does but the compiler refuses to work without it
 {
     return new FiltersAudioProcessor();
@@ -1,11 +1,14 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../Shared/ControlConditioner.h"
+#include "../../Shared/DspSafety.h"
+#include "../../Shared/OscCodec.h"
+#include "../../Shared/Station.h"
 
 class FiltersAudioProcessor :
     public juce::AudioProcessor,
-    public juce::OSCReceiver,
-    private juce::OSCReceiver::Listener<juce::OSCReceiver::MessageLoopCallback>
+    private OscCodec::Receiver::Listener
 {
 public:
     FiltersAudioProcessor();
@@ -38,18 +41,31 @@ public:
     bool isMidiEffect() const override { return false; }
 
 private:
-    void oscMessageReceived(const juce::OSCMessage& message) override;
+    void oscMessageReceived(const OscCodec::MessageView& message) override;
+    void updateCutoff(int channel, int slot, float cutoff);
+    void resetFilters();
 
     enum FilterType { LPF, HPF, BPF, NOTCH, NUM_TYPES };
-    std::array<bool, NUM_TYPES> activeFilters { false, false, false, false };
+    // Written by the OscCodec::Receiver thread and read by the audio thread
+    std::array<std::atomic<bool>, NUM_TYPES> activeFilters { false, false, false, false };
     // Filter state initialization
-    std::array<float, NUM_TYPES> cutoffHz { 1000.0f, 1000.0f, 1000.0f, 1000.0f };
+    std::array<std::atomic<float>, NUM_TYPES> cutoffHz { 1000.0f, 1000.0f, 1000.0f, 1000.0f };
     // Filter freqs initialization
 
+    // Jitter suppression and log grid for the incoming cutoffs, one per filter type
+    std::array<ControlConditioner, NUM_TYPES> cutoffConditioners {
+        ControlConditioner(ControlConditioner::frequency(20.0f, 20000.0f)),
+        ControlConditioner(ControlConditioner::frequency(20.0f, 20000.0f)),
+        ControlConditioner(ControlConditioner::frequency(20.0f, 20000.0f)),
+        ControlConditioner(ControlConditioner::frequency(20.0f, 20000.0f)) };
+
     // Separate filters for the 2 channels to avoid artifacts
     static constexpr int NUM_CHANNELS = 2;
     std::array<std::array<juce::dsp::StateVariableTPTFilter<float>, NUM_TYPES>, NUM_CHANNELS> filters;
+    std::array<std::array<float, NUM_TYPES>, NUM_CHANNELS> appliedCutoffHz {}; // Last cutoff given to each filter
     juce::dsp::ProcessSpec spec;
+    const int oscPort = Station::port(9001, Station::current());
+    OscCodec::Receiver oscReceiver;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FiltersAudioProcessor)
 };
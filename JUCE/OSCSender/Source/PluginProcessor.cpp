@@ -5,7 +5,7 @@ OSCStreamingAudioProcessor::OSCStreamingAudioProcessor()
         .withInput("Input", juce::AudioChannelSet::stereo(), true)
         .withOutput("Output", juce::AudioChannelSet::stereo(), true))
 {
-    if (!oscSender.connect("127.0.0.1", 9001)) {
+    if (!oscSocket.bindToPort(0)) {
         DBG("OSC connection error");
     }
 }
@@ -13,7 +13,15 @@ OSCStreamingAudioProcessor::OSCStreamingAudioProcessor()
 OSCStreamingAudioProcessor::~OSCStreamingAudioProcessor() {}
 
 void OSCStreamingAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock) {
-    juce::ignoreUnused(sampleRate, samplesPerBlock);
+    juce::ignoreUnused(samplesPerBlock);
+
+    // Shared memory feed for the native Visualizer, the OSC stream below stays for the Processing sketch.
+    // The Visualizer shows station 0, the other Engine chains only send OSC
+    if (station == 0 && !waveformRing.isOpen() && !waveformRing.openForWriting()) {
+        DBG("Waveform ring: failed to map " << WaveformRing::getDefaultFile().getFullPathName()
+            << " or another OSCSender is already writing it");
+    }
+    waveformRing.setSampleRate(sampleRate);
 }
 
 void OSCStreamingAudioProcessor::releaseResources() {}
@@ -29,18 +37,20 @@ void OSCStreamingAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     const int numSamples = buffer.getNumSamples();
     const int numChannels = buffer.getNumChannels();
 
-    // We build the packet
-    juce::OSCMessage msg("/waveform");
-    msg.addInt32(numChannels);
-    msg.addInt32(numSamples);
+    waveformRing.write(buffer.getArrayOfReadPointers(), numChannels, numSamples);
+
+    // We build the packet in the preallocated buffer, no OSCArgument per sample
+    waveformPacket.clear();
+    waveformPacket.beginMessage("/waveform");
+    waveformPacket.addInt32(numChannels);
+    waveformPacket.addInt32(numSamples);
 
     for (int ch = 0; ch < numChannels; ++ch) {
-        auto* samples = buffer.getReadPointer(ch);
-        for (int i = 0; i < numSamples; ++i) {
-            msg.addFloat32(samples[i]);
-        }
+        waveformPacket.addFloat32s(buffer.getReadPointer(ch), numSamples);
     }
 
-    // and send it
-    oscSender.send(msg);
+    // and send it, unless the block was too big for one UDP packet
+    if (waveformPacket.endMessage()) {
+        oscSocket.write(oscHost, oscPort, waveformPacket.getData(), (int) waveformPacket.getSize());
+    }
 }
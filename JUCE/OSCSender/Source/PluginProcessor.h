@@ -1,6 +1,9 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "../../Shared/OscCodec.h"
+#include "../../Shared/Station.h"
+#include "../../Shared/WaveformRing.h"
 
 class OSCStreamingAudioProcessor : public juce::AudioProcessor
 {
@@ -28,7 +31,12 @@ public:
     void setStateInformation (const void*, int) override {}
 
 private:
-    juce::OSCSender oscSender;
+    juce::DatagramSocket oscSocket;
+    const juce::String oscHost { "127.0.0.1" };
+    const int station = Station::current();
+    const int oscPort = Station::port(9001, station);
+    OscCodec::Writer<> waveformPacket; // Reused every block
+    WaveformRing waveformRing;
     int oscFrameCounter = 0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OSCStreamingAudioProcessor)
@@ -13,8 +13,7 @@ SimpleReverbAudioProcessor::SimpleReverbAudioProcessor()
 
 SimpleReverbAudioProcessor::~SimpleReverbAudioProcessor()
 {
-    this->OSCReceiver::disconnect();
-    this->OSCReceiver::removeListener(this);
+    oscReceiver.disconnect();
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout SimpleReverbAudioProcessor::createParameters()
@@ -27,38 +26,61 @@ juce::AudioProcessorValueTreeState::ParameterLayout SimpleReverbAudioProcessor::
 void SimpleReverbAudioProcessor::prepareToPlay(double sampleRate, int samplesPerBlock)
 {
     reverb.setSampleRate(sampleRate);
+    appliedWetness = -1.0f;
 
-    if (!this->OSCReceiver::connect(9002))  // SuperCollider must target this port
-        DBG("OSC Receiver: failed to connect to port 9002");
+    if (!oscReceiver.connect(oscPort, *this))  // SuperCollider must target this port
+        DBG("OSC Receiver: failed to connect to port " << oscPort);
     else
-        DBG("OSC connected to port 9002");
-
-    this->OSCReceiver::addListener(this, "/wet");
+        DBG("OSC connected to port " << oscPort);
 }
 
 void SimpleReverbAudioProcessor::releaseResources() {}
 
 void SimpleReverbAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&)
 {
+    // Reverb tails decay into denormals, flush them to zero instead of paying for them
+    juce::ScopedNoDenormals noDenormals;
+
     auto* wetnessParam = apvts.getRawParameterValue("WET");
     float wetness = wetnessParam->load();
 
-    reverbParams.wetLevel = wetness;
-    reverbParams.dryLevel = 1.0f - wetness;
-    reverb.setParameters(reverbParams);
+    // Only push new parameters to the reverb when the wetness actually changed
+    if (wetness != appliedWetness)
+    {
+        reverbParams.wetLevel = wetness;
+        reverbParams.dryLevel = 1.0f - wetness;
+        reverb.setParameters(reverbParams);
+        appliedWetness = wetness;
+    }
 
     juce::dsp::AudioBlock<float> block(buffer);
     juce::dsp::ProcessContextReplacing<float> context(block);
 
     reverb.processStereo(buffer.getWritePointer(0), buffer.getWritePointer(1), buffer.getNumSamples());
+
+    // Non finite output empties the comb filters, see DspSafety.h
+    if (DspSafety::containsNonFinite(buffer))
+    {
+        buffer.clear();
+        reverb.reset();
+    }
 }
 
-void SimpleReverbAudioProcessor::oscMessageReceived(const juce::OSCMessage& message)
+// Runs on the OSC receiver thread
+void SimpleReverbAudioProcessor::oscMessageReceived(const OscCodec::MessageView& message)
 {
-    if (message.getAddressPattern().toString() == "/wet" && message.size() == 1 && message[0].isFloat32())
+    if (message.hasAddress("/wet") && message.size() == 1 && message.isFloat32(0))
     {
-        float wetVal = juce::jlimit(0.0f, 1.0f, message[0].getFloat32());
-        apvts.getParameter("WET")->setValueNotifyingHost(wetVal);
+        auto* parameter = apvts.getParameter("WET");
+        float wetVal = DspSafety::sanitise(message.getFloat32(0), 0.0f, 1.0f, parameter->getValue());
+
+        const bool forward = wetConditioner.process(wetVal, wetVal);
+        wetConditioner.logStats("Reverb", "/wet");
+
+        if (!forward)
+            return;
+
+        parameter->setValueNotifyingHost(wetVal);
         DBG("OSC /wet received: " << wetVal);
     }
 }
@@ -1,9 +1,12 @@
 #pragma once
 #include <JuceHeader.h>
+#include "../../Shared/ControlConditioner.h"
+#include "../../Shared/DspSafety.h"
+#include "../../Shared/OscCodec.h"
+#include "../../Shared/Station.h"
 
 class SimpleReverbAudioProcessor : public juce::AudioProcessor,
-                                   private juce::OSCReceiver,
-                                   private juce::OSCReceiver::ListenerWithOSCAddress<juce::OSCReceiver::MessageLoopCallback>
+                                   private OscCodec::Receiver::Listener
 {
 public:
     SimpleReverbAudioProcessor();
@@ -32,10 +35,14 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
 private:
-    void oscMessageReceived(const juce::OSCMessage& message) override;
+    void oscMessageReceived(const OscCodec::MessageView& message) override;
 
     juce::Reverb reverb;
     juce::Reverb::Parameters reverbParams;
+    float appliedWetness = -1.0f;
+    ControlConditioner wetConditioner { ControlConditioner::normalised() };
+    const int oscPort = Station::port(9002, Station::current());
+    OscCodec::Receiver oscReceiver;
 
     juce::AudioProcessorValueTreeState apvts;
     static juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
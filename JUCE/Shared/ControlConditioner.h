@@ -0,0 +1,191 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+
+// Conditions the control values that come from the board (through SuperCollider) before they reach
+// the DSP. SuperCollider forwards every serial packet, so pot jitter of a couple of LSB becomes a
+// constant stream of parameter changes. Each value goes through a One Euro filter (strong smoothing
+// while the pot is still, little lag on fast gestures), an optional log grid for frequencies and a
+// deadband against the last value that was forwarded. The plugins run every incoming value through
+// one of these before touching a parameter, so dropped jitter never reaches the host automation,
+// the editor or the DSP.
+// Not thread safe: use one instance per control from the thread that receives the messages.
+class ControlConditioner
+{
+public:
+    struct Settings
+    {
+        float minValue = 0.0f;
+        float maxValue = 1.0f;
+        bool logarithmic = false;   // Condition log(value) instead of value, used for frequencies
+        int stepsPerOctave = 0;     // Perceptual grid for logarithmic controls, 0 disables it
+        float deadband = 0.01f;     // Normalised units, 0-1 over the whole range
+        float minCutoffHz = 1.0f;   // One Euro: smoothing while the control is still
+        float beta = 5.0f;          // One Euro: how quickly the smoothing opens up with speed
+    };
+
+    struct Stats
+    {
+        juce::uint64 received = 0;
+        juce::uint64 forwarded = 0;
+
+        juce::uint64 getSuppressed() const noexcept { return received - forwarded; }
+    };
+
+    // 0-1 controls such as /wet and /drive
+    static Settings normalised()
+    {
+        return {};
+    }
+
+    // Cutoff style controls, quantised to a quarter tone grid between minHz and maxHz
+    static Settings frequency(float minHz, float maxHz)
+    {
+        Settings s;
+        s.minValue = minHz;
+        s.maxValue = maxHz;
+        s.logarithmic = true;
+        s.stepsPerOctave = 24;
+        s.deadband = 0.0f; // The grid hysteresis below already acts as the deadband
+        return s;
+    }
+
+    explicit ControlConditioner(Settings s = normalised())
+        : settings(s)
+    {
+        jassert(settings.maxValue > settings.minValue);
+        jassert(! settings.logarithmic || settings.minValue > 0.0f);
+
+        if (settings.logarithmic && settings.stepsPerOctave > 0)
+        {
+            const float octaves = std::log2(settings.maxValue / settings.minValue);
+            gridStep = 1.0f / (octaves * (float) settings.stepsPerOctave);
+
+            // Hysteresis so a value sitting on a grid boundary does not flip between two steps
+            settings.deadband = juce::jmax(settings.deadband, 0.75f * gridStep);
+        }
+    }
+
+    // Returns true when the value should be forwarded to the DSP, in which case result holds the
+    // conditioned value. Returns false when the change is only jitter and should be dropped
+    bool process(float value, float& result)
+    {
+        return process(value, juce::Time::getMillisecondCounterHiRes() * 0.001, result);
+    }
+
+    bool process(float value, double timeSeconds, float& result)
+    {
+        ++stats.received;
+
+        float u = smooth(toNormalised(value), timeSeconds);
+
+        // Let the ends of the range through, a pot turned all the way down must really reach 0
+        if (u < 0.5f * settings.deadband)
+            u = 0.0f;
+        else if (u > 1.0f - 0.5f * settings.deadband)
+            u = 1.0f;
+
+        if (hasForwarded && std::abs(u - lastForwarded) <= settings.deadband && u != 0.0f && u != 1.0f)
+            return false;
+
+        if (gridStep > 0.0f)
+            u = juce::jlimit(0.0f, 1.0f, std::round(u / gridStep) * gridStep);
+
+        if (hasForwarded && u == lastForwarded)
+            return false;
+
+        hasForwarded = true;
+        lastForwarded = u;
+        ++stats.forwarded;
+        result = fromNormalised(u);
+        return true;
+    }
+
+    void reset()
+    {
+        initialised = false;
+        hasForwarded = false;
+        stats = {};
+    }
+
+    const Stats& getStats() const noexcept { return stats; }
+
+    // Writes the counts to juce::Logger at most once every intervalSeconds. Unlike DBG this stays in
+    // Release builds, so the suppression rate can be checked on the plugins that are actually installed
+    void logStats(const char* plugin, const char* control, double intervalSeconds = 10.0)
+    {
+        const double now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+
+        if (now - lastLogTime < intervalSeconds)
+            return;
+
+        lastLogTime = now;
+        juce::Logger::writeToLog(juce::String(plugin) + " " + control + ": " + juce::String(stats.received)
+                                 + " received, " + juce::String(stats.getSuppressed()) + " suppressed as jitter");
+    }
+
+private:
+    float toNormalised(float value) const
+    {
+        value = juce::jlimit(settings.minValue, settings.maxValue, value);
+
+        if (settings.logarithmic)
+            return std::log(value / settings.minValue) / std::log(settings.maxValue / settings.minValue);
+
+        return (value - settings.minValue) / (settings.maxValue - settings.minValue);
+    }
+
+    float fromNormalised(float u) const
+    {
+        if (settings.logarithmic)
+            return settings.minValue * std::pow(settings.maxValue / settings.minValue, u);
+
+        return settings.minValue + u * (settings.maxValue - settings.minValue);
+    }
+
+    // One Euro filter (Casiez et al.), the cutoff follows the smoothed speed of the control
+    float smooth(float x, double timeSeconds)
+    {
+        if (! initialised)
+        {
+            initialised = true;
+            previousX = x;
+            previousSpeed = 0.0f;
+            previousTime = timeSeconds;
+            return x;
+        }
+
+        const float dt = juce::jmax(1.0e-3f, (float) (timeSeconds - previousTime));
+        previousTime = timeSeconds;
+
+        const float speed = (x - previousX) / dt;
+        previousSpeed += alpha(dt, speedCutoffHz) * (speed - previousSpeed);
+
+        const float cutoff = settings.minCutoffHz + settings.beta * std::abs(previousSpeed);
+        previousX += alpha(dt, cutoff) * (x - previousX);
+        return previousX;
+    }
+
+    static float alpha(float dt, float cutoffHz)
+    {
+        const float tau = 1.0f / (juce::MathConstants<float>::twoPi * cutoffHz);
+        return 1.0f / (1.0f + tau / dt);
+    }
+
+    static constexpr float speedCutoffHz = 1.0f;
+
+    Settings settings;
+    float gridStep = 0.0f;
+
+    bool initialised = false;
+    float previousX = 0.0f;
+    float previousSpeed = 0.0f;
+    double previousTime = 0.0;
+
+    bool hasForwarded = false;
+    float lastForwarded = 0.0f;
+
+    Stats stats;
+    double lastLogTime = 0.0;
+};
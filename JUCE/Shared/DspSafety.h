@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <cmath>
+#include <cstring>
+
+// Guards shared by the effect plugins: validation of the values that arrive from OSC or the host,
+// and a cheap per block check for NaN/Inf so a filter or reverb whose state blew up can be reset
+// instead of feeding garbage to the rest of the chain. When the check fires, a plugin clears the block
+// and resets its DSP state. A NaN that reaches a recursive state (SVF integrators, comb filters, voice
+// envelopes) never decays on its own, so silencing only the output would not be enough
+namespace DspSafety
+{
+    // Non finite values fall back to a default, everything else is clamped into range.
+    // juce::jlimit alone lets NaN through, every comparison with it is false
+    inline float sanitise(float value, float minValue, float maxValue, float fallback) noexcept
+    {
+        return std::isfinite(value) ? juce::jlimit(minValue, maxValue, value) : fallback;
+    }
+
+    // Highest cutoff we give an SVF, it has to stay below Nyquist
+    inline float maxCutoff(double sampleRate) noexcept
+    {
+        return juce::jmin(20000.0f, (float) sampleRate * 0.45f);
+    }
+
+    // True if any sample is NaN or +-Inf (exponent bits all set). Integer ops without branches,
+    // so the loop vectorises, which a float comparison against NaN would not
+    inline bool containsNonFinite(const float* data, int numSamples) noexcept
+    {
+        juce::uint32 found = 0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            juce::uint32 bits;
+            std::memcpy(&bits, data + i, sizeof(bits));
+            found |= (juce::uint32) ((bits & 0x7f800000u) == 0x7f800000u);
+        }
+
+        return found != 0;
+    }
+
+    inline bool containsNonFinite(const juce::AudioBuffer<float>& buffer) noexcept
+    {
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            if (containsNonFinite(buffer.getReadPointer(ch), buffer.getNumSamples()))
+                return true;
+
+        return false;
+    }
+}
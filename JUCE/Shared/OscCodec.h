@@ -0,0 +1,646 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <cstring>
+#include <memory>
+
+// Small OSC 1.0 codec shared by the plugins and the Engine. Writer builds messages and bundles in a
+// buffer it owns, MessageView reads a received message in place, so neither direction allocates
+// (juce::OSCMessage allocates an OSCArgument per value and Strings for the address and the tags).
+// Receiver owns the UDP socket and its thread and hands every message of a packet to a listener
+namespace OscCodec
+{
+    // Largest UDP payload over IPv4
+    constexpr size_t maxPacketSize = 65507;
+    constexpr int maxBundleDepth = 4;
+
+    // NTP format: seconds since 1900 in the high 32 bits, fraction in the low ones
+    struct TimeTag
+    {
+        juce::uint64 raw = 1; // 1 means immediately
+
+        static TimeTag immediately() noexcept { return {}; }
+
+        static TimeTag fromTime(juce::Time time) noexcept
+        {
+            constexpr juce::int64 secondsFrom1900To1970 = 2208988800LL;
+            const auto millis = time.toMilliseconds();
+            const auto seconds = (juce::uint64) (millis / 1000 + secondsFrom1900To1970);
+            const auto fraction = (juce::uint64) (millis % 1000) * 4294967296ULL / 1000;
+            return { (seconds << 32) | fraction };
+        }
+    };
+
+    namespace Detail
+    {
+        inline size_t padded(size_t size) noexcept { return (size + 3) & ~(size_t) 3; }
+
+        inline void writeUint32(char* dest, juce::uint32 value) noexcept
+        {
+            dest[0] = (char) (value >> 24);
+            dest[1] = (char) (value >> 16);
+            dest[2] = (char) (value >> 8);
+            dest[3] = (char) value;
+        }
+
+        inline void writeUint64(char* dest, juce::uint64 value) noexcept
+        {
+            writeUint32(dest, (juce::uint32) (value >> 32));
+            writeUint32(dest + 4, (juce::uint32) value);
+        }
+
+        inline juce::uint32 readUint32(const char* src) noexcept
+        {
+            const auto* bytes = reinterpret_cast<const juce::uint8*>(src);
+            return ((juce::uint32) bytes[0] << 24) | ((juce::uint32) bytes[1] << 16)
+                 | ((juce::uint32) bytes[2] << 8) | (juce::uint32) bytes[3];
+        }
+
+        inline juce::uint64 readUint64(const char* src) noexcept
+        {
+            return ((juce::uint64) readUint32(src) << 32) | readUint32(src + 4);
+        }
+
+        inline float readFloat32(const char* src) noexcept
+        {
+            const auto bits = readUint32(src);
+            float value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        // Size of the padded string at data, or 0 if it is not terminated within size
+        inline size_t paddedStringSize(const char* data, size_t size) noexcept
+        {
+            const auto* end = static_cast<const char*>(std::memchr(data, 0, size));
+
+            if (end == nullptr)
+                return 0;
+
+            const auto total = padded((size_t) (end - data) + 1);
+            return total <= size ? total : 0;
+        }
+
+        // Bytes taken by an argument of the given type at data, or -1 if it is unknown or truncated
+        inline juce::int64 argumentSize(char type, const char* data, size_t available) noexcept
+        {
+            size_t size = 0;
+
+            switch (type)
+            {
+                case 'i': case 'f': case 'c': case 'r': case 'm':
+                    size = 4;
+                    break;
+
+                case 'h': case 'd': case 't':
+                    size = 8;
+                    break;
+
+                case 's': case 'S':
+                    size = paddedStringSize(data, available);
+                    return size > 0 ? (juce::int64) size : -1;
+
+                case 'b':
+                {
+                    if (available < 4)
+                        return -1;
+
+                    const auto length = (size_t) readUint32(data);
+
+                    if (length > available - 4)
+                        return -1;
+
+                    size = 4 + padded(length);
+                    break;
+                }
+
+                case 'T': case 'F': case 'N': case 'I':
+                    return 0;
+
+                default:
+                    return -1;
+            }
+
+            return size <= available ? (juce::int64) size : -1;
+        }
+    }
+
+    //==============================================================================
+    // A received message, pointing into the packet bytes. Only valid while they are.
+    // The indexed getters walk from the first argument, use an ArgumentReader to go through them all
+    class MessageView
+    {
+    public:
+        // Reads the arguments in order, every step is O(1)
+        class ArgumentReader
+        {
+        public:
+            explicit ArgumentReader(const MessageView& message) noexcept
+                : tag(message.typeTags), data(message.arguments) {}
+
+            bool atEnd() const noexcept                 { return *tag == 0; }
+            char getType() const noexcept               { return *tag; }
+            bool isInt32() const noexcept               { return getType() == 'i'; }
+            bool isFloat32() const noexcept             { return getType() == 'f'; }
+            bool isString() const noexcept              { return getType() == 's'; }
+            bool isNumber() const noexcept              { return isInt32() || isFloat32(); }
+
+            // Each read returns the current argument and moves to the next one. The type must match
+            juce::int32 readInt32() noexcept
+            {
+                jassert(isInt32());
+                const auto value = (juce::int32) Detail::readUint32(data);
+                skip();
+                return value;
+            }
+
+            float readFloat32() noexcept
+            {
+                jassert(isFloat32());
+                const auto value = Detail::readFloat32(data);
+                skip();
+                return value;
+            }
+
+            // Int or float as a float, like MessageView::getNumber
+            float readNumber() noexcept
+            {
+                return isInt32() ? (float) readInt32() : readFloat32();
+            }
+
+            const char* readString() noexcept
+            {
+                jassert(isString());
+                const char* value = data;
+                skip();
+                return value;
+            }
+
+            // Copies up to maxFloats consecutive float arguments, stops at the first other type
+            int readFloat32s(float* dest, int maxFloats) noexcept
+            {
+                int count = 0;
+
+                for (; count < maxFloats && isFloat32(); ++count, ++tag, data += 4)
+                    dest[count] = Detail::readFloat32(data);
+
+                return count;
+            }
+
+            void skip() noexcept
+            {
+                if (atEnd())
+                    return;
+
+                data += Detail::argumentSize(*tag, data, maxPacketSize);
+                ++tag;
+            }
+
+        private:
+            const char* tag;
+            const char* data;
+        };
+
+        // Checks the whole message up front, so the getters below need no bounds checks
+        bool parse(const char* data, size_t size) noexcept
+        {
+            address = "";
+            typeTags = "";
+            arguments = nullptr;
+            numArguments = 0;
+
+            if (size < 4 || (size & 3) != 0 || data[0] != '/')
+                return false;
+
+            const auto addressSize = Detail::paddedStringSize(data, size);
+
+            if (addressSize == 0)
+                return false;
+
+            // Old style message without a type tag string: no arguments
+            if (addressSize == size)
+            {
+                address = data;
+                return true;
+            }
+
+            const char* tags = data + addressSize;
+            const auto tagsSize = Detail::paddedStringSize(tags, size - addressSize);
+
+            if (tags[0] != ',' || tagsSize == 0)
+                return false;
+
+            const char* position = tags + tagsSize;
+            const char* end = data + size;
+            int count = 0;
+
+            for (const char* tag = tags + 1; *tag != 0; ++tag, ++count)
+            {
+                const auto argumentSize = Detail::argumentSize(*tag, position, (size_t) (end - position));
+
+                if (argumentSize < 0)
+                    return false;
+
+                position += argumentSize;
+            }
+
+            address = data;
+            typeTags = tags + 1;
+            arguments = tags + tagsSize;
+            numArguments = count;
+            return true;
+        }
+
+        const char* getAddress() const noexcept             { return address; }
+        bool hasAddress(const char* other) const noexcept   { return std::strcmp(address, other) == 0; }
+        int size() const noexcept                           { return numArguments; }
+        char getType(int index) const noexcept              { return typeTags[index]; }
+
+        bool isInt32(int index) const noexcept              { return getType(index) == 'i'; }
+        bool isFloat32(int index) const noexcept            { return getType(index) == 'f'; }
+        bool isString(int index) const noexcept             { return getType(index) == 's'; }
+        bool isBlob(int index) const noexcept               { return getType(index) == 'b'; }
+        bool isTimeTag(int index) const noexcept            { return getType(index) == 't'; }
+        bool isNumber(int index) const noexcept             { return isInt32(index) || isFloat32(index); }
+
+        juce::int32 getInt32(int index) const noexcept      { return (juce::int32) Detail::readUint32(argument(index)); }
+
+        float getFloat32(int index) const noexcept          { return Detail::readFloat32(argument(index)); }
+
+        // Int or float argument as a float, SuperCollider sends whole numbers as ints
+        float getNumber(int index) const noexcept
+        {
+            return isInt32(index) ? (float) getInt32(index) : getFloat32(index);
+        }
+
+        // Null terminated, inside the packet
+        const char* getString(int index) const noexcept     { return argument(index); }
+
+        const void* getBlob(int index, size_t& size) const noexcept
+        {
+            const char* data = argument(index);
+            size = Detail::readUint32(data);
+            return data + 4;
+        }
+
+        TimeTag getTimeTag(int index) const noexcept        { return { Detail::readUint64(argument(index)) }; }
+
+        ArgumentReader getArguments() const noexcept        { return ArgumentReader(*this); }
+
+    private:
+        // The arguments have different sizes, walk from the first one: O(index)
+        const char* argument(int index) const noexcept
+        {
+            const char* data = arguments;
+
+            for (int i = 0; i < index; ++i)
+                data += Detail::argumentSize(typeTags[i], data, maxPacketSize);
+
+            return data;
+        }
+
+        const char* address = "";
+        const char* typeTags = "";  // Without the leading comma
+        const char* arguments = nullptr;
+        int numArguments = 0;
+    };
+
+    // Calls callback(const MessageView&) for every message of a packet, inside bundles too.
+    // Bundle time tags are ignored, everything is applied as it arrives. Returns false if the
+    // packet is malformed, the messages before the error have been delivered
+    template <typename Callback>
+    bool parsePacket(const char* data, size_t size, Callback&& callback, int depth = 0)
+    {
+        if (size >= 16 && std::memcmp(data, "#bundle", 8) == 0)
+        {
+            if (depth >= maxBundleDepth)
+                return false;
+
+            for (size_t position = 16; position < size;)
+            {
+                if (size - position < 4)
+                    return false;
+
+                const auto elementSize = (size_t) Detail::readUint32(data + position);
+                position += 4;
+
+                if (elementSize > size - position
+                    || !parsePacket(data + position, elementSize, callback, depth + 1))
+                    return false;
+
+                position += elementSize;
+            }
+
+            return true;
+        }
+
+        MessageView message;
+
+        if (!message.parse(data, size))
+            return false;
+
+        callback(message);
+        return true;
+    }
+
+    //==============================================================================
+    // Builds one packet (a message or a bundle) in a buffer it owns. The type tags are collected
+    // apart and moved in front of the arguments by endMessage(). Any call that would not fit marks
+    // the packet as failed, clear() starts a new one
+    template <size_t capacity = maxPacketSize, int maxArguments = 16384>
+    class Writer
+    {
+    public:
+        void clear() noexcept
+        {
+            position = 0;
+            depth = 0;
+            numArguments = 0;
+            inMessage = false;
+            failed = false;
+        }
+
+        bool beginBundle(TimeTag timeTag = TimeTag::immediately()) noexcept
+        {
+            size_t slot;
+
+            if (inMessage || depth >= maxBundleDepth || !openElement(slot) || !ensure(16, 0))
+                return fail();
+
+            std::memcpy(data.data() + position, "#bundle", 8);
+            Detail::writeUint64(data.data() + position + 8, timeTag.raw);
+            position += 16;
+
+            bundleSlots[(size_t) depth++] = slot;
+            return true;
+        }
+
+        bool endBundle() noexcept
+        {
+            if (failed || inMessage || depth == 0)
+                return fail();
+
+            closeElement(bundleSlots[(size_t) --depth]);
+            return true;
+        }
+
+        bool beginMessage(const char* address) noexcept
+        {
+            if (inMessage || address[0] != '/' || !openElement(messageSlot))
+                return fail();
+
+            // Room for the address and the smallest type tag string
+            const auto length = std::strlen(address);
+
+            if (!ensure(Detail::padded(length + 1), 4))
+                return false;
+
+            writeString(address, length);
+            argumentsStart = position;
+            numArguments = 0;
+            inMessage = true;
+            return true;
+        }
+
+        bool endMessage() noexcept
+        {
+            if (failed || !inMessage)
+                return fail();
+
+            // The space was reserved by every add, the move cannot overflow
+            const auto tagsSize = Detail::padded((size_t) numArguments + 2);
+            char* start = data.data() + argumentsStart;
+
+            std::memmove(start + tagsSize, start, position - argumentsStart);
+            start[0] = ',';
+            std::memcpy(start + 1, tags.data(), (size_t) numArguments);
+            std::memset(start + 1 + numArguments, 0, tagsSize - 1 - (size_t) numArguments);
+
+            position += tagsSize;
+            inMessage = false;
+            closeElement(messageSlot);
+            return true;
+        }
+
+        bool addInt32(juce::int32 value) noexcept
+        {
+            if (!addArguments('i', 1, 4))
+                return false;
+
+            Detail::writeUint32(data.data() + position, (juce::uint32) value);
+            position += 4;
+            return true;
+        }
+
+        bool addFloat32(float value) noexcept
+        {
+            return addFloat32s(&value, 1);
+        }
+
+        // One argument per value, written in one pass
+        bool addFloat32s(const float* values, int numValues) noexcept
+        {
+            if (numValues < 0 || !addArguments('f', numValues, 4 * (size_t) numValues))
+                return false;
+
+            char* dest = data.data() + position;
+
+            for (int i = 0; i < numValues; ++i)
+            {
+                juce::uint32 bits;
+                std::memcpy(&bits, values + i, sizeof(bits));
+                Detail::writeUint32(dest + 4 * i, bits);
+            }
+
+            position += 4 * (size_t) numValues;
+            return true;
+        }
+
+        bool addString(const char* text) noexcept
+        {
+            const auto length = std::strlen(text);
+
+            if (!addArguments('s', 1, Detail::padded(length + 1)))
+                return false;
+
+            writeString(text, length);
+            return true;
+        }
+
+        bool addBlob(const void* blob, size_t size) noexcept
+        {
+            if (!addArguments('b', 1, 4 + Detail::padded(size)))
+                return false;
+
+            char* dest = data.data() + position;
+            Detail::writeUint32(dest, (juce::uint32) size);
+            std::memcpy(dest + 4, blob, size);
+            std::memset(dest + 4 + size, 0, Detail::padded(size) - size);
+
+            position += 4 + Detail::padded(size);
+            return true;
+        }
+
+        bool addTimeTag(TimeTag timeTag) noexcept
+        {
+            if (!addArguments('t', 1, 8))
+                return false;
+
+            Detail::writeUint64(data.data() + position, timeTag.raw);
+            position += 8;
+            return true;
+        }
+
+        // A whole message or bundle, nothing left open
+        bool isComplete() const noexcept { return !failed && !inMessage && depth == 0 && position > 0; }
+
+        const char* getData() const noexcept { return data.data(); }
+        size_t getSize() const noexcept      { return position; }
+
+    private:
+        static constexpr size_t noSlot = ~(size_t) 0;
+
+        bool fail() noexcept
+        {
+            failed = true;
+            return false;
+        }
+
+        // Fails unless bytes more fit, keeping reserve bytes free for the pending type tags
+        bool ensure(size_t bytes, size_t reserve) noexcept
+        {
+            if (failed || bytes + reserve > capacity - position)
+                return fail();
+
+            return true;
+        }
+
+        bool addArguments(char type, int count, size_t bytes) noexcept
+        {
+            if (failed || !inMessage || count > maxArguments - numArguments)
+                return fail();
+
+            if (!ensure(bytes, Detail::padded((size_t) (numArguments + count) + 2)))
+                return false;
+
+            std::memset(tags.data() + numArguments, type, (size_t) count);
+            numArguments += count;
+            return true;
+        }
+
+        // Elements of a bundle are prefixed with their size, written when they end
+        bool openElement(size_t& slot) noexcept
+        {
+            if (failed)
+                return false;
+
+            if (depth == 0)
+            {
+                // A packet holds a single message or bundle
+                slot = noSlot;
+                return position == 0;
+            }
+
+            if (!ensure(4, 0))
+                return false;
+
+            slot = position;
+            position += 4;
+            return true;
+        }
+
+        void closeElement(size_t slot) noexcept
+        {
+            if (slot != noSlot)
+                Detail::writeUint32(data.data() + slot, (juce::uint32) (position - slot - 4));
+        }
+
+        void writeString(const char* text, size_t length) noexcept
+        {
+            const auto size = Detail::padded(length + 1);
+            std::memcpy(data.data() + position, text, length);
+            std::memset(data.data() + position + length, 0, size - length);
+            position += size;
+        }
+
+        std::array<char, capacity> data {};
+        std::array<char, (size_t) maxArguments> tags {};
+        std::array<size_t, (size_t) maxBundleDepth> bundleSlots {};
+        size_t position = 0, argumentsStart = 0, messageSlot = noSlot;
+        int depth = 0, numArguments = 0;
+        bool inMessage = false, failed = false;
+    };
+
+    //==============================================================================
+    // UDP listener on its own thread, parses every packet in place into a fixed buffer.
+    // Replaces juce::OSCReceiver, which builds a juce::OSCMessage for each message
+    class Receiver : private juce::Thread
+    {
+    public:
+        struct Listener
+        {
+            virtual ~Listener() = default;
+
+            // Called on the receiver thread, the view is only valid during the call
+            virtual void oscMessageReceived(const MessageView& message) = 0;
+        };
+
+        Receiver() : Thread("OSC receiver") {}
+        ~Receiver() override { disconnect(); }
+
+        bool connect(int portNumber, Listener& listenerToUse)
+        {
+            disconnect();
+
+            auto newSocket = std::make_unique<juce::DatagramSocket>(false);
+
+            if (!newSocket->bindToPort(portNumber))
+                return false;
+
+            socket = std::move(newSocket);
+            listener = &listenerToUse;
+            startThread();
+            return true;
+        }
+
+        void disconnect()
+        {
+            if (socket == nullptr)
+                return;
+
+            signalThreadShouldExit();
+            socket->shutdown();
+            stopThread(10000);
+            socket.reset();
+        }
+
+    private:
+        void run() override
+        {
+            while (!threadShouldExit())
+            {
+                // Wakes up now and then to check threadShouldExit, shutdown() ends the wait too
+                const int ready = socket->waitUntilReady(true, 100);
+
+                if (ready < 0 || threadShouldExit())
+                    return;
+
+                if (ready == 0)
+                    continue;
+
+                const int bytesRead = socket->read(buffer.data(), (int) buffer.size(), false);
+
+                if (bytesRead >= 4)
+                    parsePacket(buffer.data(), (size_t) bytesRead,
+                                [this](const MessageView& message) { listener->oscMessageReceived(message); });
+            }
+        }
+
+        std::unique_ptr<juce::DatagramSocket> socket;
+        Listener* listener = nullptr;
+        std::array<char, maxPacketSize> buffer {};
+
+        JUCE_DECLARE_NON_COPYABLE(Receiver)
+    };
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Which T.I.L.E.S station a plugin instance belongs to. AudioPluginHost runs a single station, 0.
+// The Engine can run one chain per station in the same process: it sets TILES_STATION before
+// creating the plugins of each chain, and every plugin reads it once in its constructor.
+// Station s listens on the usual OSC ports plus s * portStride (station 1: 9011, 9012...), so the
+// stations don't fight over the same ports. Only station 0 writes the waveform ring, because the
+// Visualizer shows a single station.
+namespace Station
+{
+    constexpr const char* environmentVariable = "TILES_STATION";
+    constexpr int portStride = 10;
+
+    inline int current()
+    {
+        return juce::jmax(0, juce::SystemStats::getEnvironmentVariable(environmentVariable, "0").getIntValue());
+    }
+
+    inline int port(int basePort, int station) noexcept
+    {
+        return basePort + station * portStride;
+    }
+}
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+// Single producer / single consumer ring of mono samples that lives in a memory mapped file.
+// The OSCSender plugin writes into it from the audio thread and the Visualizer app reads from
+// it on its own timer, so the waveform never goes through OSC serialisation or a UDP socket.
+// Only one writer is allowed: openForWriting() claims the ring in its header and fails while
+// another live instance owns it. A writer that stops writing for a few seconds loses its claim
+class WaveformRing
+{
+public:
+    static constexpr juce::uint32 ringMagic   = 0x54494c45; // "TILE"
+    static constexpr juce::uint32 ringVersion = 2;
+    static constexpr int capacity = 1 << 15; // Must be a power of two, ~0.7 s at 48 kHz
+
+    WaveformRing() = default;
+    ~WaveformRing() { close(); }
+
+    static juce::File getDefaultFile()
+    {
+        return juce::File::getSpecialLocation(juce::File::tempDirectory).getChildFile("tiles_waveform.ring");
+    }
+
+    // Maps the ring read/write, creating the backing file when it is missing or from an older layout.
+    // Fails if another writer holds the ring. Call it from prepareToPlay, never from the audio thread
+    bool openForWriting(const juce::File& file = getDefaultFile())
+    {
+        close();
+
+        if (! hasValidLayout(file))
+        {
+            juce::FileOutputStream out(file);
+            if (out.failedToOpen())
+                return false;
+
+            out.setPosition(0);
+            out.truncate();
+            out.writeRepeatedByte(0, totalBytes);
+            out.flush();
+        }
+
+        mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readWrite, false);
+        if (! attach())
+            return false;
+
+        if (! claimWriter())
+        {
+            close();
+            return false;
+        }
+
+        header->magic = ringMagic;
+        header->version = ringVersion;
+        header->capacity = (juce::uint32) capacity;
+        return true;
+    }
+
+    // Maps a ring previously created by openForWriting, fails if nobody has created it yet
+    bool openForReading(const juce::File& file = getDefaultFile())
+    {
+        close();
+
+        if (! hasValidLayout(file))
+            return false;
+
+        mappedFile = std::make_unique<juce::MemoryMappedFile>(file, juce::MemoryMappedFile::readOnly, false);
+        return attach();
+    }
+
+    void close()
+    {
+        // Hands the ring over to the next writer right away instead of after the timeout
+        if (header != nullptr && ownerToken != 0)
+        {
+            auto expected = ownerToken;
+            header->owner.compare_exchange_strong(expected, 0);
+        }
+
+        ownerToken = 0;
+        header = nullptr;
+        data = nullptr;
+        mappedFile.reset();
+    }
+
+    bool isOpen() const noexcept { return header != nullptr; }
+
+    void setSampleRate(double sampleRate) noexcept
+    {
+        if (header != nullptr)
+            header->sampleRate.store((juce::uint32) sampleRate, std::memory_order_relaxed);
+    }
+
+    double getSampleRate() const noexcept
+    {
+        return header != nullptr ? (double) header->sampleRate.load(std::memory_order_relaxed) : 0.0;
+    }
+
+    // Audio thread: appends the mono mix of the given channels, no locks and no allocations
+    void write(const float* const* channels, int numChannels, int numSamples) noexcept
+    {
+        if (header == nullptr || numChannels <= 0 || header->owner.load(std::memory_order_relaxed) != ownerToken)
+            return;
+
+        const auto start = header->writeIndex.load(std::memory_order_relaxed);
+        const auto end = start + (juce::uint64) numSamples;
+        const float scale = 1.0f / (float) numChannels;
+
+        // Announces the slots about to be overwritten before touching them, see read()
+        header->reserveIndex.store(end, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            float sum = 0.0f;
+            for (int ch = 0; ch < numChannels; ++ch)
+                sum += channels[ch][i];
+
+            data[(start + (juce::uint64) i) & mask] = sum * scale;
+        }
+
+        header->writeIndex.store(end, std::memory_order_release);
+        header->heartbeat.store((juce::uint64) juce::Time::currentTimeMillis(), std::memory_order_relaxed);
+    }
+
+    // Total number of samples written so far, used by the reader to detect new data
+    juce::uint64 getWriteIndex() const noexcept
+    {
+        return header != nullptr ? header->writeIndex.load(std::memory_order_acquire) : 0;
+    }
+
+    // Copies the numSamples samples that end at endIndex into dest, oldest first.
+    // Samples that were never written are returned as silence. Returns false if the writer
+    // lapped the reader during the copy, dest is then partly overwritten and should be dropped
+    bool read(juce::uint64 endIndex, float* dest, int numSamples) const noexcept
+    {
+        jassert(numSamples <= capacity);
+
+        if (header == nullptr)
+            return false;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const auto age = (juce::uint64) (numSamples - i);
+            dest[i] = endIndex >= age ? data[(endIndex - age) & mask] : 0.0f;
+        }
+
+        // Seqlock style check: every slot the writer has started on since is reserved already
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto reserved = header->reserveIndex.load(std::memory_order_relaxed);
+        const auto oldest = endIndex - juce::jmin(endIndex, (juce::uint64) numSamples);
+
+        return reserved <= oldest + (juce::uint64) capacity;
+    }
+
+private:
+    struct Header
+    {
+        juce::uint32 magic;
+        juce::uint32 version;
+        juce::uint32 capacity;
+        std::atomic<juce::uint32> sampleRate;
+        std::atomic<juce::uint64> writeIndex;
+        std::atomic<juce::uint64> reserveIndex;   // End of the block being written
+        std::atomic<juce::uint32> owner;          // Token of the current writer, 0 if none
+        std::atomic<juce::uint64> heartbeat;      // Wall clock ms of the writer's last block
+    };
+
+    // The header is shared between processes, so the atomics must not hide a lock
+    static_assert(std::atomic<juce::uint64>::is_always_lock_free, "64-bit atomics must be lock free");
+    static_assert(sizeof(Header) <= 64, "Header must fit before the sample data");
+    static_assert((capacity & (capacity - 1)) == 0, "Capacity must be a power of two");
+
+    static constexpr juce::uint64 mask = (juce::uint64) capacity - 1;
+    static constexpr juce::uint64 staleWriterMillis = 2000;
+    static constexpr size_t dataOffset = 64;
+    static constexpr size_t totalBytes = dataOffset + sizeof(float) * (size_t) capacity;
+
+    static bool hasValidLayout(const juce::File& file)
+    {
+        if (file.getSize() != (juce::int64) totalBytes)
+            return false;
+
+        juce::FileInputStream in(file);
+        return in.openedOk()
+            && (juce::uint32) in.readInt() == ringMagic
+            && (juce::uint32) in.readInt() == ringVersion
+            && in.readInt() == capacity;
+    }
+
+    bool claimWriter()
+    {
+        const auto now = (juce::uint64) juce::Time::currentTimeMillis();
+        auto owner = header->owner.load(std::memory_order_acquire);
+
+        // A writer that crashed or was never closed stops beating and can be replaced
+        if (owner != 0 && now - header->heartbeat.load(std::memory_order_relaxed) < staleWriterMillis)
+            return false;
+
+        const auto token = (juce::uint32) juce::Random::getSystemRandom().nextInt() | 1u;
+
+        if (! header->owner.compare_exchange_strong(owner, token, std::memory_order_acq_rel))
+            return false;
+
+        ownerToken = token;
+        header->heartbeat.store(now, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool attach()
+    {
+        if (mappedFile == nullptr || mappedFile->getData() == nullptr || mappedFile->getSize() < totalBytes)
+        {
+            mappedFile.reset();
+            return false;
+        }
+
+        auto* base = static_cast<char*>(mappedFile->getData());
+        header = reinterpret_cast<Header*>(base);
+        data = reinterpret_cast<float*>(base + dataOffset);
+        return true;
+    }
+
+    std::unique_ptr<juce::MemoryMappedFile> mappedFile;
+    Header* header = nullptr;
+    float* data = nullptr;
+    juce::uint32 ownerToken = 0;
+
+    JUCE_DECLARE_NON_COPYABLE(WaveformRing)
+};
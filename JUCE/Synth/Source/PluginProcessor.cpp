@@ -0,0 +1,206 @@
+#include "PluginProcessor.h"
+
+namespace
+{
+    const char* const tileIds[SynthAudioProcessor::numTiles] = { "VOL1", "VOL2", "VOL3", "VOL4",
+                                                                 "ATTACK", "DECAY", "SUSTAIN", "RELEASE",
+                                                                 "FM", "LFO", "MASTER", "PAN" };
+
+    const char* const tileNames[SynthAudioProcessor::numTiles] = { "Sine", "Pulse", "Triangle", "Saw",
+                                                                   "Attack", "Decay", "Sustain", "Release",
+                                                                   "FM Rate", "LFO", "Master", "Pan" };
+
+    // Same defaults as the SynthDef when no tile has been read yet (FM 0.35 maps to its fmRate of 1 Hz),
+    // except that the sine is audible instead of all four volumes at 0
+    const float tileDefaults[SynthAudioProcessor::numTiles] = { 1.0f, 0.0f, 0.0f, 0.0f,
+                                                                0.0f, 0.15f, 0.5f, 0.5f,
+                                                                0.35f, 0.0f, 1.0f, 0.5f };
+
+    // The potentiometers on the board read 0 to 900
+    constexpr float tileRange = 900.0f;
+
+    // SuperCollider's linexp, including its clipping of the input
+    float linexp(float value, float inMin, float inMax, float outMin, float outMax) noexcept
+    {
+        const float position = (juce::jlimit(inMin, inMax, value) - inMin) / (inMax - inMin);
+        return outMin * std::pow(outMax / outMin, position);
+    }
+}
+
+SynthAudioProcessor::SynthAudioProcessor()
+    : AudioProcessor(BusesProperties().withOutput("Output", juce::AudioChannelSet::stereo(), true)),
+      apvts(*this, nullptr, "Parameters", createParameters())
+{
+    for (int i = 0; i < numTiles; ++i)
+        tileValues[(size_t) i] = apvts.getRawParameterValue(tileIds[i]);
+}
+
+SynthAudioProcessor::~SynthAudioProcessor()
+{
+    oscReceiver.disconnect();
+}
+
+juce::AudioProcessorValueTreeState::ParameterLayout SynthAudioProcessor::createParameters()
+{
+    // The parameters are the tile positions, mapped to seconds and Hz like Project.scd did
+    std::vector<std::unique_ptr<juce::RangedAudioParameter>> params;
+
+    for (int i = 0; i < numTiles; ++i)
+        params.push_back(std::make_unique<juce::AudioParameterFloat>(tileIds[i], tileNames[i], 0.0f, 1.0f, tileDefaults[i]));
+
+    return { params.begin(), params.end() };
+}
+
+void SynthAudioProcessor::prepareToPlay(double sampleRate, int)
+{
+    voices.prepare(sampleRate);
+
+    if (!oscReceiver.connect(oscPort, *this))
+        DBG("OSC Receiver: failed to connect to port " << oscPort);
+    else
+        DBG("OSC connected to port " << oscPort);
+}
+
+void SynthAudioProcessor::releaseResources()
+{
+    voices.reset();
+}
+
+bool SynthAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const
+{
+    return layouts.getMainOutputChannelSet() == juce::AudioChannelSet::stereo();
+}
+
+VoicePool::Parameters SynthAudioProcessor::getVoiceParameters() const noexcept
+{
+    auto tile = [this](int i) { return tileValues[(size_t) i]->load(); };
+
+    VoicePool::Parameters parameters;
+
+    for (int i = 0; i < 4; ++i)
+        parameters.volumes[(size_t) i] = tile(i);
+
+    parameters.attack = linexp(tile(4), 0.0f, 1.0f, 0.01f, 45.0f);
+    parameters.decay = tile(5) * 2.0f;
+    parameters.sustain = tile(6);
+    parameters.release = tile(7) * 2.0f;
+    parameters.fmRate = linexp(tile(8), 0.01f, 1.0f, 0.3f, 10.0f);
+    parameters.lfoFreq = linexp(tile(9), 0.01f, 1.0f, 1.0f, 12.0f);
+    parameters.master = tile(10);
+    parameters.pan = tile(11) * 2.0f - 1.0f;
+
+    return parameters;
+}
+
+void SynthAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
+{
+    juce::ScopedNoDenormals noDenormals;
+
+    buffer.clear();
+
+    // Tile changes reach the notes that are already sounding, once per block
+    voices.setParameters(getVoiceParameters());
+
+    const int numSamples = buffer.getNumSamples();
+    auto* left = buffer.getWritePointer(0);
+    auto* right = buffer.getWritePointer(1);
+    int position = 0;
+
+    // Render up to each event, so a note starts at the sample it was played and not at the next block
+    for (const auto metadata : midiMessages)
+    {
+        const int eventPosition = juce::jlimit(position, numSamples, metadata.samplePosition);
+
+        voices.render(left + position, right + position, eventPosition - position);
+        position = eventPosition;
+
+        handleMidiEvent(metadata.getMessage());
+    }
+
+    voices.render(left + position, right + position, numSamples - position);
+
+    // Non finite output stops every voice, see DspSafety.h
+    if (DspSafety::containsNonFinite(buffer))
+    {
+        buffer.clear();
+        voices.reset();
+    }
+}
+
+void SynthAudioProcessor::handleMidiEvent(const juce::MidiMessage& message) noexcept
+{
+    // A note on with velocity 0 counts as a note off, as in Project.scd
+    if (message.isNoteOn())
+        voices.noteOn(message.getNoteNumber());
+    else if (message.isNoteOff())
+        voices.noteOff(message.getNoteNumber());
+    else if (message.isAllSoundOff())
+        voices.reset();
+    else if (message.isAllNotesOff())
+        voices.releaseAll();
+}
+
+// Runs on the OSC receiver thread
+void SynthAudioProcessor::oscMessageReceived(const OscCodec::MessageView& message)
+{
+    if (!message.hasAddress("/synth/tiles") || message.size() != numTiles)
+        return;
+
+    auto arguments = message.getArguments();
+
+    for (int i = 0; i < numTiles; ++i)
+    {
+        // SuperCollider sends the raw readings as integers
+        if (!arguments.isNumber())
+        {
+            arguments.skip();
+            continue;
+        }
+
+        auto* parameter = apvts.getParameter(tileIds[i]);
+        float value = DspSafety::sanitise(arguments.readNumber() / tileRange, 0.0f, 1.0f, parameter->getValue());
+
+        if (tileConditioners[(size_t) i].process(value, value))
+            parameter->setValueNotifyingHost(value);
+
+        tileConditioners[(size_t) i].logStats("Synth", tileIds[i]);
+    }
+}
+
+juce::AudioProcessorEditor* SynthAudioProcessor::createEditor()
+{
+    return new juce::GenericAudioProcessorEditor(*this);
+}
+
+bool SynthAudioProcessor::hasEditor() const { return true; }
+const juce::String SynthAudioProcessor::getName() const { return "Synth"; }
+bool SynthAudioProcessor::acceptsMidi() const { return true; }
+bool SynthAudioProcessor::producesMidi() const { return false; }
+bool SynthAudioProcessor::isMidiEffect() const { return false; }
+double SynthAudioProcessor::getTailLengthSeconds() const { return 2.0; } // Longest release
+
+int SynthAudioProcessor::getNumPrograms() { return 1; }
+int SynthAudioProcessor::getCurrentProgram() { return 0; }
+void SynthAudioProcessor::setCurrentProgram(int) {}
+const juce::String SynthAudioProcessor::getProgramName(int) { return {}; }
+void SynthAudioProcessor::changeProgramName(int, const juce::String&) {}
+
+void SynthAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
+{
+    if (auto xml = apvts.state.createXml())
+        copyXmlToBinary(*xml, destData);
+}
+
+void SynthAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
+{
+    if (auto xml = getXmlFromBinary(data, sizeInBytes))
+    {
+        if (xml->hasTagName(apvts.state.getType()))
+            apvts.replaceState(juce::ValueTree::fromXml(*xml));
+    }
+}
+
+juce::AudioProcessor* JUCE_CALLTYPE createPluginFilter()
+{
+    return new SynthAudioProcessor();
+}
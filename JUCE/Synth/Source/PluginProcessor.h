@@ -0,0 +1,61 @@
+#pragma once
+#include <JuceHeader.h>
+#include <array>
+#include "../../Shared/ControlConditioner.h"
+#include "../../Shared/DspSafety.h"
+#include "../../Shared/OscCodec.h"
+#include "../../Shared/Station.h"
+#include "VoicePool.h"
+
+// Instrument that plays the MIDI notes with the \multiOsc sound of Project.scd. SuperCollider
+// only forwards the tile positions (OSC /synth/tiles on port 9005), the notes come straight
+// from the host's MIDI input and start at the sample they were played at
+class SynthAudioProcessor : public juce::AudioProcessor,
+                            private OscCodec::Receiver::Listener
+{
+public:
+    SynthAudioProcessor();
+    ~SynthAudioProcessor() override;
+
+    void prepareToPlay(double sampleRate, int samplesPerBlock) override;
+    void releaseResources() override;
+    bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
+    void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+
+    juce::AudioProcessorEditor* createEditor() override;
+    bool hasEditor() const override;
+
+    const juce::String getName() const override;
+    bool acceptsMidi() const override;
+    bool producesMidi() const override;
+    bool isMidiEffect() const override;
+    double getTailLengthSeconds() const override;
+
+    int getNumPrograms() override;
+    int getCurrentProgram() override;
+    void setCurrentProgram(int index) override;
+    const juce::String getProgramName(int index) override;
+    void changeProgramName(int index, const juce::String& newName) override;
+
+    void getStateInformation(juce::MemoryBlock& destData) override;
+    void setStateInformation(const void* data, int sizeInBytes) override;
+
+    // Volumes 1-4, ADSR, FM rate, LFO, master and pan, in the order of the /synth/tiles arguments
+    static constexpr int numTiles = 12;
+
+private:
+    void oscMessageReceived(const OscCodec::MessageView& message) override;
+    void handleMidiEvent(const juce::MidiMessage& message) noexcept;
+    VoicePool::Parameters getVoiceParameters() const noexcept;
+
+    juce::AudioProcessorValueTreeState apvts;
+    std::array<std::atomic<float>*, numTiles> tileValues {};
+    std::array<ControlConditioner, numTiles> tileConditioners;
+    VoicePool voices;
+    const int oscPort = Station::port(9005, Station::current());
+    OscCodec::Receiver oscReceiver;
+
+    static juce::AudioProcessorValueTreeState::ParameterLayout createParameters();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SynthAudioProcessor)
+};
@@ -0,0 +1,254 @@
+#include "VoicePool.h"
+
+namespace
+{
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+
+    // Env.adsr(curve: -8) segments are exponentials with a time constant of 1/8 of the segment.
+    // A one pole that aims slightly past the end level reaches it exactly at the segment time,
+    // and unlike a precomputed curve it keeps working when the time changes halfway
+    constexpr float curve = 8.0f;
+    const float overshoot = std::exp(-curve) / (1.0f - std::exp(-curve));
+
+    // The SynthDef divides the mix by 17 to leave headroom for chords
+    constexpr float voiceHeadroom = 1.0f / 17.0f;
+
+    float segmentCoefficient(float seconds, double sampleRate) noexcept
+    {
+        const auto samples = juce::jmax(1.0, (double) seconds * sampleRate);
+        return (float) std::exp(-curve / samples);
+    }
+
+    // Removes the step of the pulse and saw at the wrap, so they don't alias like the naive shapes
+    float polyBlep(float t, float dt) noexcept
+    {
+        if (t < dt)
+        {
+            t /= dt;
+            return t + t - t * t - 1.0f;
+        }
+
+        if (t > 1.0f - dt)
+        {
+            t = (t - 1.0f) / dt;
+            return t * t + t + t + 1.0f;
+        }
+
+        return 0.0f;
+    }
+
+    float wrap(float phase) noexcept
+    {
+        return phase >= 1.0f ? phase - 1.0f : phase;
+    }
+}
+
+void VoicePool::prepare(double sampleRateToUse) noexcept
+{
+    sampleRate = sampleRateToUse;
+    reset();
+}
+
+void VoicePool::reset() noexcept
+{
+    stage.fill(idle);
+    level.fill(0.0f);
+    numActive = 0;
+}
+
+void VoicePool::setParameters(const Parameters& parameters) noexcept
+{
+    // The SynthDef normalises the mix by the sum of the four volumes
+    float sumVolumes = 0.0f;
+
+    for (auto volume : parameters.volumes)
+        sumVolumes += volume;
+
+    for (size_t i = 0; i < gains.size(); ++i)
+        gains[i] = sumVolumes > 0.0f ? parameters.volumes[i] / sumVolumes : 0.0f;
+
+    attackCoefficient = segmentCoefficient(parameters.attack, sampleRate);
+    attackTarget = 1.0f + overshoot;
+
+    decayCoefficient = segmentCoefficient(parameters.decay, sampleRate);
+    decayTarget = parameters.sustain - (1.0f - parameters.sustain) * overshoot;
+
+    releaseCoefficient = segmentCoefficient(parameters.release, sampleRate);
+
+    fmIncrement = (float) (parameters.fmRate / sampleRate);
+    fmDepth = parameters.fmRate > 0.31f ? 0.05f : 0.0f;
+
+    lfoIncrement = (float) (parameters.lfoFreq / sampleRate);
+    lfoEnabled = parameters.lfoFreq > 1.1f;
+
+    // Equal power panning, like Pan2
+    const float angle = (juce::jlimit(-1.0f, 1.0f, parameters.pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+    const float outputGain = parameters.master * voiceHeadroom;
+
+    leftGain = std::cos(angle) * outputGain;
+    rightGain = std::sin(angle) * outputGain;
+}
+
+int VoicePool::allocateVoice(int noteNumber) noexcept
+{
+    // The same note again restarts its own voice instead of doubling it
+    for (int a = 0; a < numActive; ++a)
+        if (note[(size_t) active[(size_t) a]] == noteNumber)
+            return active[(size_t) a];
+
+    if (numActive < maxVoices)
+        for (int v = 0; v < maxVoices; ++v)
+            if (stage[(size_t) v] == idle)
+                return v;
+
+    // Pool full: steal the oldest released voice, or the oldest one if every note is still held
+    int oldest = active[0], oldestReleased = -1;
+
+    for (int a = 0; a < numActive; ++a)
+    {
+        const int v = active[(size_t) a];
+        const auto age = nextStartOrder - startOrder[(size_t) v];
+
+        if (age > nextStartOrder - startOrder[(size_t) oldest])
+            oldest = v;
+
+        if (stage[(size_t) v] == release
+            && (oldestReleased < 0 || age > nextStartOrder - startOrder[(size_t) oldestReleased]))
+            oldestReleased = v;
+    }
+
+    return oldestReleased >= 0 ? oldestReleased : oldest;
+}
+
+void VoicePool::noteOn(int noteNumber) noexcept
+{
+    const int v = allocateVoice(noteNumber);
+    const auto index = (size_t) v;
+
+    // A reused voice attacks from its current level and phase, so there is no click
+    if (stage[index] == idle)
+    {
+        active[(size_t) numActive++] = v;
+        phase[index] = 0.0f;
+        fmPhase[index] = 0.0f;
+        lfoPhase[index] = 0.0f;
+        level[index] = 0.0f;
+    }
+
+    // Velocity is ignored, as in the SynthDef
+    note[index] = noteNumber;
+    phaseIncrement[index] = (float) (juce::MidiMessage::getMidiNoteInHertz(noteNumber) / sampleRate);
+    stage[index] = attack;
+    startOrder[index] = nextStartOrder++;
+}
+
+void VoicePool::noteOff(int noteNumber) noexcept
+{
+    for (int a = 0; a < numActive; ++a)
+    {
+        const auto index = (size_t) active[(size_t) a];
+
+        if (note[index] == noteNumber && stage[index] != release)
+            startRelease(index);
+    }
+}
+
+void VoicePool::releaseAll() noexcept
+{
+    for (int a = 0; a < numActive; ++a)
+    {
+        const auto index = (size_t) active[(size_t) a];
+
+        if (stage[index] != release)
+            startRelease(index);
+    }
+}
+
+void VoicePool::startRelease(size_t index) noexcept
+{
+    // The overshoot is relative to the segment, so a note released halfway up the attack (or from a
+    // low sustain) still takes the whole release time to reach 0
+    releaseTarget[index] = -level[index] * overshoot;
+    stage[index] = release;
+}
+
+void VoicePool::render(float* left, float* right, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    for (int a = 0; a < numActive; ++a)
+    {
+        const auto index = (size_t) active[(size_t) a];
+
+        float p = phase[index], fp = fmPhase[index], lp = lfoPhase[index], env = level[index];
+        const float increment = phaseIncrement[index];
+        const float endTarget = releaseTarget[index];
+        auto st = stage[index];
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            if (st == attack)
+            {
+                env = attackTarget + (env - attackTarget) * attackCoefficient;
+
+                if (env >= 1.0f)
+                {
+                    env = 1.0f;
+                    st = decay;
+                }
+            }
+            else if (st == decay)
+            {
+                // Decays into the sustain level and stays there until the note off
+                env = decayTarget + (env - decayTarget) * decayCoefficient;
+            }
+            else
+            {
+                env = endTarget + (env - endTarget) * releaseCoefficient;
+
+                if (env <= 0.0f)
+                {
+                    env = 0.0f;
+                    st = idle;
+                    break;
+                }
+            }
+
+            const float dt = increment * (1.0f + fmDepth * std::sin(twoPi * fp));
+
+            const float sine = std::sin(twoPi * p);
+            const float pulse = (p < 0.5f ? 1.0f : -1.0f) + polyBlep(p, dt) - polyBlep(wrap(p + 0.5f), dt);
+            const float triangle = 1.0f - 4.0f * std::abs(p - 0.5f);
+            const float saw = 2.0f * p - 1.0f - polyBlep(p, dt);
+
+            float sample = gains[0] * sine + gains[1] * pulse + gains[2] * triangle + gains[3] * saw;
+
+            if (lfoEnabled)
+                sample *= 0.7f + 0.3f * std::sin(twoPi * lp);
+
+            sample *= env;
+            left[i] += sample * leftGain;
+            right[i] += sample * rightGain;
+
+            p = wrap(p + dt);
+            fp = wrap(fp + fmIncrement);
+            lp = wrap(lp + lfoIncrement);
+        }
+
+        phase[index] = p;
+        fmPhase[index] = fp;
+        lfoPhase[index] = lp;
+        level[index] = env;
+        stage[index] = st;
+    }
+
+    // Finished voices go back to the pool
+    int kept = 0;
+
+    for (int a = 0; a < numActive; ++a)
+        if (stage[(size_t) active[(size_t) a]] != idle)
+            active[(size_t) kept++] = active[(size_t) a];
+
+    numActive = kept;
+}
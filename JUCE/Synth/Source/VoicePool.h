@@ -0,0 +1,76 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Fixed pool of the \multiOsc voices that Project.scd used to create as one server Synth per note.
+// The per voice state is kept as one array per field (structure of arrays), so rendering walks
+// contiguous memory and nothing is allocated after prepare(). The tile parameters are shared by
+// all voices and applied once per block, so held notes follow the ADSR and FX tiles live
+class VoicePool
+{
+public:
+    static constexpr int maxVoices = 32;
+
+    // The SynthDef arguments, already mapped from the tile positions
+    struct Parameters
+    {
+        std::array<float, 4> volumes {};    // Sine, pulse, triangle, saw, 0 to 1
+        float attack = 0.01f;               // Seconds
+        float decay = 0.3f;                 // Seconds
+        float sustain = 0.5f;               // Level, 0 to 1
+        float release = 1.0f;               // Seconds
+        float fmRate = 1.0f;                // Hz, vibrato is off up to 0.31 Hz
+        float lfoFreq = 1.0f;               // Hz, tremolo is off up to 1.1 Hz
+        float master = 1.0f;                // 0 to 1
+        float pan = 0.0f;                   // -1 to 1
+    };
+
+    void prepare(double sampleRateToUse) noexcept;
+    void reset() noexcept;
+
+    // Called once per block, before rendering
+    void setParameters(const Parameters& parameters) noexcept;
+
+    void noteOn(int noteNumber) noexcept;
+    void noteOff(int noteNumber) noexcept;
+    void releaseAll() noexcept;
+
+    // Adds the active voices to the two channels
+    void render(float* left, float* right, int numSamples) noexcept;
+
+    int getNumActiveVoices() const noexcept { return numActive; }
+
+private:
+    enum Stage : juce::uint8 { idle, attack, decay, release };
+
+    int allocateVoice(int noteNumber) noexcept;
+    void startRelease(size_t index) noexcept;
+
+    double sampleRate = 44100.0;
+
+    // Per voice state, one array per field
+    alignas(64) std::array<float, maxVoices> phase {};
+    alignas(64) std::array<float, maxVoices> phaseIncrement {};
+    alignas(64) std::array<float, maxVoices> fmPhase {};
+    alignas(64) std::array<float, maxVoices> lfoPhase {};
+    alignas(64) std::array<float, maxVoices> level {};
+    alignas(64) std::array<float, maxVoices> releaseTarget {}; // Scaled by the level at the note off
+    std::array<Stage, maxVoices> stage {};
+    std::array<int, maxVoices> note {};
+    std::array<juce::uint32, maxVoices> startOrder {};
+
+    std::array<int, maxVoices> active {}; // Indices of the voices that are not idle
+    int numActive = 0;
+    juce::uint32 nextStartOrder = 0;
+
+    // Shared by all voices, recomputed by setParameters()
+    std::array<float, 4> gains {};
+    float attackCoefficient = 0.0f, attackTarget = 0.0f;
+    float decayCoefficient = 0.0f, decayTarget = 0.0f;
+    float releaseCoefficient = 0.0f;
+    float fmIncrement = 0.0f, fmDepth = 0.0f;
+    float lfoIncrement = 0.0f;
+    bool lfoEnabled = false;
+    float leftGain = 0.0f, rightGain = 0.0f;
+};
@@ -0,0 +1,346 @@
+#include "MainComponent.h"
+
+namespace
+{
+    const juce::Colour titleColour(230, 40, 40);
+    const juce::Colour gridColour(200, 200, 200);
+    const juce::Colour waveformColour(255, 51, 0);
+    const juce::Colour scopeColour(0, 120, 255);
+    const juce::Colour fallbackBackground(180, 50, 90);
+}
+
+MainComponent::MainComponent()
+    : history(historySize, 0.0f),
+      capturedWave(scopeSize, 0.0f)
+{
+    // Decoded a single time, the sketch reloaded and resized the PNG on every frame
+    backgroundImage = juce::ImageCache::getFromMemory(BinaryData::background_png, BinaryData::background_pngSize);
+
+    setOpaque(true);
+    setWantsKeyboardFocus(true);
+    setSize(1000, 600);
+
+    ring.openForReading();
+    startTimerHz(frameRate);
+}
+
+MainComponent::~MainComponent()
+{
+    stopTimer();
+}
+
+void MainComponent::resized()
+{
+    plotArea = { 70, 150, getWidth() - 140, getHeight() - 250 };
+    statusArea = { 20, 90, getWidth() - 40, 35 };
+
+    columnMin.assign((size_t) juce::jmax(1, plotArea.getWidth()), 0.0f);
+    columnMax.assign(columnMin.size(), 0.0f);
+
+    rebuildStaticLayer();
+    rebuildColumns();
+}
+
+void MainComponent::rebuildStaticLayer()
+{
+    if (getWidth() <= 0 || getHeight() <= 0)
+        return;
+
+    staticLayer = juce::Image(juce::Image::RGB, getWidth(), getHeight(), false);
+    juce::Graphics g(staticLayer);
+    const auto bounds = getLocalBounds().toFloat();
+
+    // Fallback to a plain colour if the image could not be loaded
+    if (backgroundImage.isValid())
+        g.drawImage(backgroundImage, bounds);
+    else
+        g.fillAll(fallbackBackground);
+
+    g.setColour(juce::Colours::black.withAlpha((juce::uint8) 230));
+    g.fillRoundedRectangle(20.0f, 80.0f, bounds.getWidth() - 40.0f, bounds.getHeight() - 90.0f, 15.0f);
+
+    // Header
+    const juce::Rectangle<float> header(bounds.getCentreX() - 250.0f, 10.0f, 500.0f, 60.0f);
+    g.setColour(juce::Colours::black.withAlpha((juce::uint8) 100));
+    g.fillRoundedRectangle(header, 10.0f);
+
+    g.setColour(titleColour);
+    g.setFont(juce::FontOptions(42.0f, juce::Font::bold));
+    g.drawText("T.I.L.E.S Wave visualizer", header, juce::Justification::centred, false);
+
+    // Instructions
+    juce::String instructions = "1: Waveform | 2: Oscilloscope | SPACE: Capture now | R: Reset";
+    if (displayMode == OSCILLOSCOPE)
+        instructions << " | U/D: Adjust trigger (" << juce::String(triggerThreshold, 2) << ")";
+
+    g.setFont(juce::FontOptions(18.0f));
+    g.drawText(instructions, 0, getHeight() - 40, getWidth(), 25, juce::Justification::centred, false);
+
+    // Grid
+    const auto area = plotArea.toFloat();
+    g.setColour(gridColour);
+
+    if (displayMode == WAVEFORM)
+    {
+        g.drawHorizontalLine(plotArea.getCentreY(), area.getX(), area.getRight());
+        for (int i = 0; i <= 4; ++i)
+            g.drawVerticalLine(plotArea.getX() + i * plotArea.getWidth() / 4, area.getY(), area.getBottom());
+    }
+    else
+    {
+        g.setFont(juce::FontOptions(14.0f));
+
+        for (int i = 0; i <= 8; ++i)
+        {
+            const int y = plotArea.getY() + i * plotArea.getHeight() / 8;
+            g.setColour(gridColour);
+            g.drawHorizontalLine(y, area.getX(), area.getRight());
+
+            // Amplitude values
+            g.setColour(juce::Colours::grey);
+            g.drawText(juce::String(1.0f - (float) i / 4.0f, 1), plotArea.getX() - 50, y - 10, 40, 20,
+                       juce::Justification::centredRight, false);
+        }
+
+        for (int i = 0; i <= 8; ++i)
+        {
+            g.setColour(i == 0 ? juce::Colours::grey : gridColour);
+            g.drawVerticalLine(plotArea.getX() + i * plotArea.getWidth() / 8, area.getY(), area.getBottom());
+        }
+
+        // Sample index labels
+        g.setColour(juce::Colours::grey);
+        for (int i = 0; i <= 4; ++i)
+            g.drawText(juce::String(i * scopeSize / 4), plotArea.getX() + i * plotArea.getWidth() / 4 - 20,
+                       plotArea.getBottom() + 5, 40, 20, juce::Justification::centredTop, false);
+    }
+}
+
+void MainComponent::paint(juce::Graphics& g)
+{
+    // Everything static comes from the cached layer, the clip region keeps this to the dirty rectangle
+    g.drawImageAt(staticLayer, 0, 0);
+
+    if (g.clipRegionIntersects(statusArea))
+    {
+        g.setFont(juce::FontOptions(20.0f));
+        g.setColour(hasSignal ? juce::Colour(0, 150, 0) : juce::Colour(200, 0, 0));
+        g.drawText(juce::String("MODE: ") + (displayMode == WAVEFORM ? "WAVEFORM" : "OSCILLOSCOPE"),
+                   statusArea, juce::Justification::centred, false);
+
+        if (displayMode == OSCILLOSCOPE)
+        {
+            g.setColour(juce::Colours::red);
+            g.drawText("Trigger: " + juce::String(triggerThreshold, 2), statusArea.withTrimmedLeft(30),
+                       juce::Justification::centredLeft, false);
+        }
+    }
+
+    if (! g.clipRegionIntersects(plotArea))
+        return;
+
+    if (! hasSignal)
+        drawNoSignal(g);
+    else if (displayMode == WAVEFORM)
+        drawWaveform(g);
+    else
+        drawOscilloscope(g);
+}
+
+void MainComponent::drawWaveform(juce::Graphics& g) const
+{
+    const float midY = (float) plotArea.getCentreY();
+    const float scale = (float) plotArea.getHeight() * 0.5f * 0.8f;
+    const float top = (float) plotArea.getY();
+    const float bottom = (float) plotArea.getBottom();
+
+    g.setColour(waveformColour);
+
+    float previousMin = columnMin[0];
+    float previousMax = columnMax[0];
+
+    for (size_t x = 0; x < columnMin.size(); ++x)
+    {
+        // Extend each span to the previous column so the trace stays connected
+        const float hi = juce::jmax(columnMax[x], previousMin);
+        const float lo = juce::jmin(columnMin[x], previousMax);
+        previousMin = columnMin[x];
+        previousMax = columnMax[x];
+
+        const float y0 = juce::jlimit(top, bottom, midY - hi * scale);
+        const float y1 = juce::jlimit(top, bottom, midY - lo * scale);
+        g.fillRect(juce::Rectangle<float>((float) plotArea.getX() + (float) x, y0, 2.0f, juce::jmax(2.0f, y1 - y0)));
+    }
+
+    // Vertical line indicating current position
+    g.setColour(juce::Colours::lime.withAlpha((juce::uint8) 100));
+    g.drawVerticalLine(plotArea.getRight() - 1, top, bottom);
+}
+
+void MainComponent::drawOscilloscope(juce::Graphics& g) const
+{
+    const auto area = plotArea.toFloat();
+    const float midY = area.getCentreY();
+    const float scale = area.getHeight() * 0.5f * 0.8f;
+
+    juce::Path trace;
+    trace.preallocateSpace(3 * scopeSize);
+
+    for (int i = 0; i < scopeSize; ++i)
+    {
+        const float x = juce::jmap((float) i, 0.0f, (float) (scopeSize - 1), area.getX(), area.getRight());
+        const float y = juce::jlimit(area.getY(), area.getBottom(), midY - capturedWave[(size_t) i] * scale);
+
+        if (i == 0)
+            trace.startNewSubPath(x, y);
+        else
+            trace.lineTo(x, y);
+    }
+
+    g.setColour(scopeColour);
+    g.strokePath(trace, juce::PathStrokeType(3.0f));
+
+    // Zero line and trigger level
+    g.setColour(juce::Colours::black.withAlpha((juce::uint8) 150));
+    g.drawHorizontalLine(plotArea.getCentreY(), area.getX(), area.getRight());
+
+    g.setColour(juce::Colours::red.withAlpha((juce::uint8) 100));
+    g.drawHorizontalLine((int) (midY - triggerThreshold * scale), area.getX(), area.getRight());
+
+    g.setColour(triggerFound ? juce::Colour(0, 150, 0) : juce::Colour(200, 0, 0));
+    g.setFont(juce::FontOptions(18.0f));
+    g.drawText(triggerFound ? "Triggered" : "Auto", plotArea.reduced(10), juce::Justification::topRight, false);
+}
+
+void MainComponent::drawNoSignal(juce::Graphics& g) const
+{
+    g.setColour(juce::Colour(200, 0, 0));
+    g.setFont(juce::FontOptions(24.0f));
+
+    auto text = getLocalBounds().withSizeKeepingCentre(getWidth(), 60);
+    g.drawText("NO SIGNAL DETECTED", text.removeFromTop(30), juce::Justification::centred, false);
+    g.drawText("Check that the OSCSender plugin is running", text, juce::Justification::centred, false);
+}
+
+void MainComponent::timerCallback()
+{
+    const auto writeIndex = ring.getWriteIndex();
+
+    if (writeIndex == lastWriteIndex)
+    {
+        ++framesWithoutData;
+
+        // The plugin may not have created the ring yet, retry about once per second
+        if (! ring.isOpen() && framesWithoutData % frameRate == 0)
+            ring.openForReading();
+
+        // Reset signal status after 3 seconds of no data
+        if (hasSignal && framesWithoutData > signalTimeoutFrames)
+        {
+            hasSignal = false;
+            repaint(statusArea);
+            repaint(plotArea);
+        }
+        return;
+    }
+
+    lastWriteIndex = writeIndex;
+    framesWithoutData = 0;
+
+    if (! hasSignal)
+    {
+        hasSignal = true;
+        repaint(statusArea);
+    }
+
+    // The plugin overwrote part of the history while we copied it, the next frame gets a clean copy
+    if (! ring.read(writeIndex, history.data(), historySize))
+        return;
+
+    if (displayMode == WAVEFORM)
+        rebuildColumns();
+    else
+        captureOscilloscope();
+
+    repaint(plotArea);
+}
+
+void MainComponent::rebuildColumns()
+{
+    // Min/max decimation: each pixel column covers several samples, so we draw a span instead of every vertex
+    const int numColumns = (int) columnMin.size();
+
+    for (int x = 0; x < numColumns; ++x)
+    {
+        const int start = x * historySize / numColumns;
+        const int end = juce::jmax(start + 1, (x + 1) * historySize / numColumns);
+        const auto range = juce::FloatVectorOperations::findMinAndMax(history.data() + start, end - start);
+
+        columnMin[(size_t) x] = range.getStart();
+        columnMax[(size_t) x] = range.getEnd();
+    }
+}
+
+void MainComponent::captureOscilloscope()
+{
+    // Look for the most recent rising edge crossing the threshold with a full window after it
+    triggerFound = false;
+
+    for (int i = historySize - scopeSize; i > 0; --i)
+    {
+        if (history[(size_t) i - 1] < triggerThreshold && history[(size_t) i] >= triggerThreshold)
+        {
+            std::copy(history.begin() + i, history.begin() + i + scopeSize, capturedWave.begin());
+            triggerFound = true;
+            framesWithoutTrigger = 0;
+            return;
+        }
+    }
+
+    // If no trigger is found for too long, force an update to show changes in the signal
+    if (++framesWithoutTrigger > triggerTimeoutFrames)
+    {
+        std::copy(history.end() - scopeSize, history.end(), capturedWave.begin());
+        framesWithoutTrigger = 0;
+    }
+}
+
+void MainComponent::resetWaveforms()
+{
+    std::fill(history.begin(), history.end(), 0.0f);
+    std::fill(capturedWave.begin(), capturedWave.end(), 0.0f);
+    rebuildColumns();
+}
+
+bool MainComponent::keyPressed(const juce::KeyPress& key)
+{
+    const auto c = key.getTextCharacter();
+
+    if (c == '1' || c == '2')
+    {
+        displayMode = (c == '1') ? WAVEFORM : OSCILLOSCOPE;
+        rebuildColumns();
+    }
+    else if (c == ' ' && displayMode == OSCILLOSCOPE)
+    {
+        // Capture the current waveform without waiting for a trigger
+        std::copy(history.end() - scopeSize, history.end(), capturedWave.begin());
+    }
+    else if (c == 'r')
+    {
+        resetWaveforms();
+    }
+    else if ((c == 'u' || c == 'd') && displayMode == OSCILLOSCOPE)
+    {
+        const float step = (c == 'u') ? 0.05f : -0.05f;
+        triggerThreshold = juce::jlimit(-0.95f, 0.95f, triggerThreshold + step);
+    }
+    else
+    {
+        return false;
+    }
+
+    rebuildStaticLayer();
+    repaint();
+    return true;
+}
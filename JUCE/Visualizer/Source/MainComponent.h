@@ -0,0 +1,58 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Shared/WaveformRing.h"
+
+// Native replacement for the Processing sketch: reads the OSCSender waveform from shared memory,
+// keeps the background and grid in a cached layer and only repaints the plot when new audio arrives
+class MainComponent : public juce::Component,
+                      private juce::Timer
+{
+public:
+    MainComponent();
+    ~MainComponent() override;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    bool keyPressed(const juce::KeyPress& key) override;
+
+private:
+    void timerCallback() override;
+
+    void captureOscilloscope();
+    void rebuildColumns();
+    void rebuildStaticLayer();
+    void resetWaveforms();
+
+    void drawWaveform(juce::Graphics& g) const;
+    void drawOscilloscope(juce::Graphics& g) const;
+    void drawNoSignal(juce::Graphics& g) const;
+
+    enum DisplayMode { WAVEFORM, OSCILLOSCOPE };
+
+    static constexpr int frameRate = 60;
+    static constexpr int historySize = 2048;   // Same history length as the Processing sketch
+    static constexpr int scopeSize = 256;
+    static constexpr int signalTimeoutFrames = 3 * frameRate;
+    static constexpr int triggerTimeoutFrames = frameRate / 10;
+
+    WaveformRing ring;
+    juce::uint64 lastWriteIndex = 0;
+    int framesWithoutData = 0;
+    int framesWithoutTrigger = 0;
+    bool hasSignal = false;
+    bool triggerFound = false;
+
+    DisplayMode displayMode = WAVEFORM;
+    float triggerThreshold = 0.05f;
+
+    std::vector<float> history;
+    std::vector<float> capturedWave;
+    std::vector<float> columnMin, columnMax; // One min/max pair per horizontal pixel of the plot
+
+    juce::Image backgroundImage;   // Decoded once
+    juce::Image staticLayer;       // Background, panel, titles and grid, rebuilt only on resize or mode change
+    juce::Rectangle<int> plotArea, statusArea;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MainComponent)
+};